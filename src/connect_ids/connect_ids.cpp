@@ -20,7 +20,8 @@ void print_observation(const Division::Observation &ob, const int id) {
   std::cout << std::endl;
 }
 
-int prompt(Division &div, std::vector<Division> &potential_matches,
+int prompt(Division &div, const std::vector<Division> &base_divs,
+           const std::vector<std::pair<double, int>> &potential_matches,
            int progress, int total) {
   std::system("clear");
   std::cout << "[" << progress << "/" << total << "]" << std::endl << std::endl;
@@ -34,8 +35,9 @@ int prompt(Division &div, std::vector<Division> &potential_matches,
               << "\t\t ===== NO MATCHES FOUND =====" << std::endl
               << std::endl;
   } else {
-    for (Division &match : potential_matches) {
-      for (Division::Observation &ob : match.obs) {
+    for (const auto &[score, base_idx] : potential_matches) {
+      const Division &match = base_divs[base_idx];
+      for (const Division::Observation &ob : match.obs) {
         std::cout << selection_id << "  |\t";
         print_observation(ob, match.id);
       }
@@ -77,8 +79,9 @@ int prompt(Division &div, std::vector<Division> &potential_matches,
     }
 
     std::cout << "Changed division's ID from " << div.id
-              << " to: " << potential_matches[SID].id << std::endl;
-    div.id = potential_matches[SID].id;
+              << " to: " << base_divs[potential_matches[SID].second].id
+              << std::endl;
+    div.id = base_divs[potential_matches[SID].second].id;
 
     printf("Enter any character to continue... ");
     std::cin >> response;
@@ -97,7 +100,7 @@ double calculate_proximity_score(double base_val, double ob_val) {
   double ratio = std::min(base_val / ob_val, ob_val / base_val);
 
   // Minimum acceptable ratio (e.g., 1/1.1 = 0.909 for 10% tolerance)
-  double min_ratio = 1.0 / FUZZY_WEIGHT;
+  double min_ratio = 1.0 / (1.0 + FUZZY_WEIGHT);
 
   if (ratio < min_ratio)
     return 0.0; // Outside tolerance
@@ -107,121 +110,163 @@ double calculate_proximity_score(double base_val, double ob_val) {
   return score;
 }
 
-std::vector<Division>
-find_potential_matches(Division &div,
-                       std::vector<Division> &potential_base_divs) {
-  Division::Observation first_ob =
+double calculate_match_score(const Division &div,
+                             const similarity::Signature &div_sig,
+                             const Division &base,
+                             const similarity::Signature &base_sig) {
+  const Division::Observation &first_ob =
       div.obs[0]; // earliest observation of the division that is trying to
                   // connect
-  std::vector<std::pair<int, Division>> ranking;
-
-  for (const Division &base : potential_base_divs) {
-    // Find base observation (could be within list of observations, i.e. no
-    // observations from 1994-1997)
-    int base_ob_idx = -1;
-    for (int i = 0; i < base.obs.size(); i++) {
-      if (base.obs[i].year < first_ob.year) {
-        base_ob_idx = i;
-      }
-    }
 
-    // Did not find a base observation
-    if (base_ob_idx < 0)
-      continue;
+  // Find base observation (could be within list of observations, i.e. no
+  // observations from 1994-1997)
+  int base_ob_idx = MatchIndex::get_base_ob_idx(base, first_ob.year);
 
-    // No overlap of years
-    bool overlap = false;
-    for (int i = base_ob_idx + 1; i < base.obs.size(); i++) {
-      for (int j = 0; j < div.obs.size(); j++) {
-        if (base.obs[i].year == div.obs[j].year) {
-          overlap = true;
-          goto done_checking;
-        }
-      }
-    }
-  done_checking:
+  // Did not find a base observation
+  if (base_ob_idx < 0)
+    return 0;
 
-    // Found overlap
-    if (overlap)
-      continue;
+  // No overlap of years
+  for (int i = base_ob_idx + 1; i < base.obs.size(); i++) {
+    if (div.has_year(base.obs[i].year))
+      return 0;
+  }
 
-    Division::Observation base_ob = base.obs[base_ob_idx];
-    int value = 0;
-
-    // Perfect match
-    // Check if number of employees or number of manhours or sales abroad is
-    // perfectly consistent
-    if (base_ob.year == first_ob.year - 1 &&
-        (base_ob.vars[7] == first_ob.vars[6] ||
-         base_ob.vars[4] == first_ob.vars[3] ||
-         base_ob.vars[1] == first_ob.vars[0])) {
-      ranking.push_back(std::make_pair(1000, base));
-      continue;
-    }
+  const Division::Observation &base_ob = base.obs[base_ob_idx];
+  double value = 0;
+
+  // Perfect match
+  // Check if number of employees or number of manhours or sales abroad is
+  // perfectly consistent
+  auto equal = [](const double a, const double b) {
+    return a != EMPTY_NUM && a == b;
+  };
+  if (base_ob.year == first_ob.year - 1 &&
+      (equal(base_ob.vars[7], first_ob.vars[6]) ||
+       equal(base_ob.vars[4], first_ob.vars[3]) ||
+       equal(base_ob.vars[1], first_ob.vars[0])))
+    return 1000;
+
+  // Fuzzy match
+  // Check if number of employed or number of worked hours or third field is
+  // decently consistent
+  double score1 = calculate_proximity_score(base_ob.vars[7], first_ob.vars[6]);
+  double score2 = calculate_proximity_score(base_ob.vars[4], first_ob.vars[3]);
+  double score3 = calculate_proximity_score(base_ob.vars[1], first_ob.vars[0]);
+  value += score1 + score2 + score3;
+
+  // Fuzzy match entry names (tokens across all years, spelling variants
+  // included)
+  const double name_similarity = similarity::jaccard(div_sig, base_sig);
+  if (name_similarity >= NAME_SIMILARITY)
+    value += NAME_SCORE * name_similarity;
+
+  // Attempt ID conversion
+  if (div.id * 10 - 1000000 == base.id)
+    value += 25;
+
+  return value;
+}
 
-    // Fuzzy match
-    // Check if number of employed or number of worked hours or third field is
-    // decently consistent
-    double score1 =
-        calculate_proximity_score(base_ob.vars[7], first_ob.vars[6]);
-    double score2 =
-        calculate_proximity_score(base_ob.vars[4], first_ob.vars[3]);
-    double score3 =
-        calculate_proximity_score(base_ob.vars[1], first_ob.vars[0]);
-    value += score1 + score2 + score3;
-
-    // Fuzzy match entry names
-
-    // Tokenise base names across all years
-    std::set<std::string> base_name_tokens;
-    for (const Division::Observation &ob : base.obs) {
-      std::vector<std::string> tokens = csv::tokenise(ob.name, ' ');
-      for (const std::string &token : tokens) {
-        base_name_tokens.insert(token);
-      }
-    }
+std::vector<std::pair<double, int>>
+find_potential_matches(const Division &div, const MatchIndex &index) {
+  const similarity::Signature div_sig = get_name_signature(div);
 
-    // Tokenise the division's names across all years
-    std::set<std::string> cmp_name_tokens;
-    for (const Division::Observation &ob : div.obs) {
-      std::vector<std::string> tokens = csv::tokenise(ob.name, ' ');
-      for (const std::string token : tokens) {
-        cmp_name_tokens.insert(token);
-      }
-    }
+  std::vector<std::pair<double, int>> ranking;
+  for (const int base_idx : index.candidates(div, div_sig)) {
+    double value =
+        calculate_match_score(div, div_sig, index.base_divs[base_idx],
+                              index.name_signatures[base_idx]);
+    if (value >= VALUE_THRESHOLD)
+      ranking.push_back({value, base_idx});
+  }
 
-    // Add points if the base names' tokens are similar to the division's names'
-    // tokens
-    std::vector<std::string> save_tokens;
-    for (const std::string &token : base_name_tokens) {
-      if (cmp_name_tokens.find(token) != cmp_name_tokens.end() &&
-          token != "AB" && token != "BRUK" && token != "ABB" && token != "CO" &&
-          token != "&" && token != "STORA" && token != "SVENSKA") {
-        save_tokens.push_back(token);
-        value += 5;
-      }
-    }
+  std::sort(ranking.begin(), ranking.end());
 
-    // Attempt ID conversion
-    if (div.id * 10 - 1000000 == base.id)
-      value += 25;
+  return ranking;
+}
 
-    if (value >= VALUE_THRESHOLD)
-      ranking.push_back(std::make_pair(value, base));
+std::vector<LinkDecision> decide_links(const std::vector<Division> &to_connect,
+                                       const MatchIndex &index) {
+  std::vector<LinkDecision> decisions(to_connect.size());
+
+  ThreadPool pool(N_THREADS);
+  pool.parallel_for((int)to_connect.size(), [&](int i) {
+    LinkDecision &decision = decisions[i];
+    decision.ranking = find_potential_matches(to_connect[i], index);
+
+    int n_above = 0;
+    for (const auto &[score, base_idx] : decision.ranking) {
+      if (score >= ACCEPT_THRESHOLD)
+        n_above++;
+    }
+
+    if (decision.ranking.empty())
+      decision.type = LinkDecision::REJECT;
+    else if (n_above == 1 && decision.ranking.back().first >= ACCEPT_THRESHOLD)
+      decision.type = LinkDecision::ACCEPT;
+    else
+      decision.type = LinkDecision::REVIEW;
+  });
+
+  // A base division accepted by several divisions needs review
+  std::map<int, int> n_claims;
+  for (const LinkDecision &decision : decisions) {
+    if (decision.type == LinkDecision::ACCEPT)
+      n_claims[decision.ranking.back().second]++;
+  }
+  for (LinkDecision &decision : decisions) {
+    if (decision.type == LinkDecision::ACCEPT &&
+        n_claims[decision.ranking.back().second] > 1)
+      decision.type = LinkDecision::REVIEW;
   }
 
-  std::sort(ranking.begin(), ranking.end(),
-            [](const auto &a, const auto &b) { return a.first < b.first; });
+  return decisions;
+}
 
-  std::vector<Division> potential_matches;
-  for (const auto &p : ranking) {
-    potential_matches.push_back(p.second);
+void write_links(const std::vector<Division> &to_connect,
+                 const std::vector<int> &old_ids,
+                 const std::vector<LinkDecision> &decisions,
+                 const std::vector<Division> &base_divs,
+                 const std::vector<std::string> &sources) {
+  std::vector<std::vector<std::string>> links, audit;
+
+  for (int i = 0; i < to_connect.size(); i++) {
+    const Division &div = to_connect[i];
+    const LinkDecision &decision = decisions[i];
+    const bool linked = div.id != old_ids[i];
+
+    if (linked)
+      links.push_back(
+          {std::to_string(old_ids[i]), std::to_string(div.id), sources[i]});
+
+    // Best two matches
+    std::vector<std::string> row = {
+        std::to_string(old_ids[i]), div.obs[0].name,
+        std::to_string(div.obs[0].year), decision_names[decision.type],
+        std::to_string(decision.ranking.size())};
+    for (int k = 1; k <= 2; k++) {
+      if (k <= decision.ranking.size()) {
+        const auto &[score, base_idx] =
+            decision.ranking[decision.ranking.size() - k];
+        row.push_back(std::to_string(base_divs[base_idx].id));
+        row.push_back(csv::dtostr(score));
+      } else {
+        row.push_back(EMPTY);
+        row.push_back(EMPTY);
+      }
+    }
+    row.push_back(linked ? std::to_string(div.id) : EMPTY);
+    audit.push_back(row);
   }
 
-  return potential_matches;
+  csv::write("links.csv", links, ',', {"id", "linked_id", "source"});
+  csv::write("audit.csv", audit, ',',
+             {"id", "name", "first_year", "decision", "n_matches", "best_id",
+              "best_score", "second_id", "second_score", "linked_id"});
 }
 
-void start_prompter(Database &db) {
+void start_prompter(Database &db, const Mode mode) {
   std::vector<Division> to_connect;
   std::vector<Division> potential_base_divs;
 
@@ -233,12 +278,86 @@ void start_prompter(Database &db) {
       potential_base_divs.push_back(div);
   }
 
-  int i = 0;
-  for (Division &div : to_connect) {
-    std::vector<Division> potential_matches =
-        find_potential_matches(div, potential_base_divs);
-    if (prompt(div, potential_matches, i++ + 1, (int)to_connect.size()))
-      break;
+  const MatchIndex index(potential_base_divs, to_connect);
+  const std::vector<LinkDecision> decisions = decide_links(to_connect, index);
+
+  std::vector<int> old_ids;
+  for (const Division &div : to_connect) {
+    old_ids.push_back(div.id);
+  }
+
+  // Link the accepted divisions, then replay the decisions of earlier sessions
+  LinkJournal journal(JOURNAL_PATH);
+  journal.load();
+
+  std::vector<std::string> sources(to_connect.size(), EMPTY);
+  int n_review = 0;
+  for (int i = 0; i < to_connect.size(); i++) {
+    if (mode != INTERACTIVE && decisions[i].type == LinkDecision::ACCEPT) {
+      to_connect[i].id =
+          potential_base_divs[decisions[i].ranking.back().second].id;
+      sources[i] = "auto";
+    }
+
+    const LinkJournal::Entry *entry = journal.find(old_ids[i]);
+    if (entry != nullptr) {
+      to_connect[i].id =
+          entry->base_id == LinkJournal::NO_LINK ? old_ids[i] : entry->base_id;
+      sources[i] = "journal";
+    } else if (decisions[i].type == LinkDecision::REVIEW) {
+      n_review++;
+    }
+  }
+
+  if (mode != BATCH) {
+    int progress = 0;
+    const int total = mode == REVIEW ? n_review : (int)to_connect.size();
+    for (int i = 0; i < to_connect.size(); i++) {
+      if (mode == REVIEW && decisions[i].type != LinkDecision::REVIEW)
+        continue;
+      if (sources[i] == "journal") {
+        progress += mode == INTERACTIVE;
+        continue;
+      }
+
+      if (prompt(to_connect[i], potential_base_divs, decisions[i].ranking,
+                 ++progress, total))
+        break;
+
+      // Journal the decision, with the score of the chosen (or best) match
+      double score = EMPTY_NUM;
+      for (const auto &[match_score, base_idx] : decisions[i].ranking) {
+        if (to_connect[i].id == old_ids[i] ||
+            potential_base_divs[base_idx].id == to_connect[i].id)
+          score = match_score;
+      }
+
+      const bool linked = to_connect[i].id != old_ids[i];
+      journal.append(old_ids[i],
+                     linked ? to_connect[i].id : LinkJournal::NO_LINK, score);
+      sources[i] = "manual";
+    }
+  }
+
+  // Resolve the links to canonical IDs. Links that would merge observations of
+  // the same year (e.g. two divisions linked to one base) are refused.
+  LinkageGraph graph;
+  std::vector<int> base_ids;
+  for (int i = 0; i < to_connect.size(); i++) {
+    base_ids.push_back(to_connect[i].id);
+    to_connect[i].id = old_ids[i];
+    graph.add(to_connect[i]);
+  }
+  for (const Division &div : potential_base_divs) {
+    graph.add(div);
+  }
+
+  for (int i = 0; i < to_connect.size(); i++) {
+    if (base_ids[i] != old_ids[i] && !graph.link(old_ids[i], base_ids[i]))
+      std::cerr << "WARNING: Conflicting link (observations in the same "
+                   "year) refused: { id: "
+                << old_ids[i] << ", base_id: " << base_ids[i] << " }"
+                << std::endl;
   }
 
   db.plandata.divs.clear();
@@ -246,14 +365,43 @@ void start_prompter(Database &db) {
                           to_connect.end());
   db.plandata.divs.insert(db.plandata.divs.end(), potential_base_divs.begin(),
                           potential_base_divs.end());
+  graph.apply(db.plandata);
+
+  for (int i = 0; i < to_connect.size(); i++) {
+    to_connect[i].id = graph.find(old_ids[i]);
+  }
+  write_links(to_connect, old_ids, decisions, potential_base_divs, sources);
 }
 
 } // namespace plan_database
 
-int main() {
+int main(int argc, char *argv[]) {
+  // --batch: link without prompting, --review: only prompt for ambiguous
+  // divisions, --apply: only apply the journal
+  plan_database::Mode mode = plan_database::INTERACTIVE;
+  bool apply_only = false;
+  for (int i = 1; i < argc; i++) {
+    const std::string arg = argv[i];
+    if (arg == "--batch")
+      mode = plan_database::BATCH;
+    else if (arg == "--review")
+      mode = plan_database::REVIEW;
+    else if (arg == "--apply")
+      apply_only = true;
+    else
+      throw std::runtime_error("ERROR: Invalid argument: " + arg);
+  }
+
   plan_database::Database db;
   db.plandata.parse_csv("../data/plan1975-2000-full.csv", ',', true);
-  start_prompter(db);
+  if (apply_only) {
+    plan_database::LinkJournal journal(JOURNAL_PATH);
+    journal.load();
+    std::cout << "Linked " << journal.apply(db.plandata) << " divisions"
+              << std::endl;
+  } else {
+    start_prompter(db, mode);
+  }
   db.plandata.write_csv("out.csv", ';', true);
 
   return 0;
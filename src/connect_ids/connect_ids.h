@@ -1,4 +1,7 @@
 #include "../lib/db.h"
+#include "../lib/journal.h"
+#include "../lib/pool.h"
+#include "match_index.h"
 #include <set>
 
 // Parameters
@@ -9,6 +12,16 @@
   1997 // Year to search for observations to match with previous years
 #define VALUE_THRESHOLD                                                        \
   1.5 // Minimum matching value for divisions to be considered a potential match
+#define NAME_SIMILARITY                                                        \
+  0.3 // Minimum similarity (Jaccard of 3-grams) for names to score, scaled to
+      // up to NAME_SCORE
+#define NAME_SCORE 10
+#define ACCEPT_THRESHOLD                                                       \
+  1000 // Minimum matching value to link without review (--batch, --review)
+#define N_THREADS 0 // Threads scoring divisions (0: all hardware threads)
+#define JOURNAL_PATH                                                           \
+  "journal.csv" // Decisions made in prompts, replayed (not asked again) on
+                // restart
 
 // ANSI color codes
 #define RESET "\033[0m"
@@ -28,15 +41,44 @@ namespace plan_database {
 
 const std::vector<std::string> color_alternator = {MAGENTA, RED, BLUE};
 
+// INTERACTIVE: prompt for every division. BATCH: link divisions with one
+// match above ACCEPT_THRESHOLD, never prompt. REVIEW: as BATCH, then prompt
+// for the ambiguous divisions only. Divisions decided in JOURNAL_PATH are not
+// prompted for (the journal overrides automatic links).
+enum Mode { INTERACTIVE, BATCH, REVIEW };
+
+struct LinkDecision {
+  // ACCEPT: a single match above ACCEPT_THRESHOLD (claimed by no other
+  // division). REJECT: no match above VALUE_THRESHOLD. REVIEW: the rest.
+  enum Type { ACCEPT, REVIEW, REJECT };
+  Type type;
+  std::vector<std::pair<double, int>> ranking; // see find_potential_matches()
+};
+const std::string decision_names[] = {"accept", "review", "reject"};
+
 void print_observation(const Division::Observation &ob, const int id);
-int prompt(Division &div, std::vector<Division> &potential_matches,
+int prompt(Division &div, const std::vector<Division> &base_divs,
+           const std::vector<std::pair<double, int>> &potential_matches,
            int progress, int total);
 
 double calculate_proximity_score(double base_val, double ob_val);
-std::vector<Division>
-find_potential_matches(Division &div,
-                       std::vector<Division> &potential_base_divs);
+double calculate_match_score(const Division &div,
+                             const similarity::Signature &div_sig,
+                             const Division &base,
+                             const similarity::Signature &base_sig);
+// Ranking (score, index in index.base_divs) of the potential matches, best
+// last
+std::vector<std::pair<double, int>>
+find_potential_matches(const Division &div, const MatchIndex &index);
+
+std::vector<LinkDecision> decide_links(const std::vector<Division> &to_connect,
+                                       const MatchIndex &index);
+void write_links(const std::vector<Division> &to_connect,
+                 const std::vector<int> &old_ids,
+                 const std::vector<LinkDecision> &decisions,
+                 const std::vector<Division> &base_divs,
+                 const std::vector<std::string> &sources);
 
-void start_prompter(Database &db);
+void start_prompter(Database &db, const Mode mode = INTERACTIVE);
 
 } // namespace plan_database
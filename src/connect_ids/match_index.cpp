@@ -0,0 +1,124 @@
+#include "connect_ids.h"
+#include <unordered_map>
+
+namespace plan_database {
+
+similarity::Signature get_name_signature(const Division &div) {
+  std::set<std::string> tokens;
+  for (const Division::Observation &ob : div.obs) {
+    if (csv::empty(ob.name))
+      continue;
+
+    for (const std::string &token : similarity::fold_tokens(ob.name)) {
+      if (name_stopwords.find(token) == name_stopwords.end())
+        tokens.insert(token);
+    }
+  }
+
+  return similarity::signature(
+      std::vector<std::string>(tokens.begin(), tokens.end()));
+}
+
+MatchIndex::MatchIndex(const std::vector<Division> &_base_divs,
+                       const std::vector<Division> &to_connect)
+    : base_divs(_base_divs), ngram_index(SIGNATURE_BITS) {
+  for (int idx = 0; idx < base_divs.size(); idx++) {
+    name_signatures.push_back(get_name_signature(base_divs[idx]));
+    for (const int bit : similarity::get_bits(name_signatures[idx])) {
+      ngram_index[bit].push_back(idx);
+    }
+
+    id_index.insert({base_divs[idx].id, idx});
+  }
+
+  // Value indexes for the first years of the divisions to connect
+  for (const Division &div : to_connect) {
+    const int year = div.obs[0].year;
+    if (value_index.find(year) != value_index.end())
+      continue;
+
+    auto &sorted = value_index[year];
+    for (int idx = 0; idx < base_divs.size(); idx++) {
+      const int ob_idx = get_base_ob_idx(base_divs[idx], year);
+      if (ob_idx < 0)
+        continue;
+
+      const std::vector<double> &vars = base_divs[idx].obs[ob_idx].vars;
+      for (int k = 0; k < value_vars.size(); k++) {
+        if (vars[value_vars[k].first] != EMPTY_NUM)
+          sorted[k].push_back({vars[value_vars[k].first], idx});
+      }
+    }
+
+    for (auto &values : sorted) {
+      std::sort(values.begin(), values.end());
+    }
+  }
+}
+
+std::vector<int>
+MatchIndex::candidates(const Division &div,
+                       const similarity::Signature &div_sig) const {
+  std::vector<int> idxs;
+
+  // Names sharing enough 3-grams to reach NAME_SIMILARITY (the union is at
+  // least div_sig.count)
+  std::unordered_map<int, int> n_shared;
+  for (const int bit : similarity::get_bits(div_sig)) {
+    for (const int idx : ngram_index[bit]) {
+      n_shared[idx]++;
+    }
+  }
+  const int min_shared =
+      std::max(1, (int)std::ceil(NAME_SIMILARITY * div_sig.count - 1e-9));
+  for (const auto &[idx, n] : n_shared) {
+    if (n >= min_shared)
+      idxs.push_back(idx);
+  }
+
+  // ID conversion
+  auto id_it = id_index.find(div.id * 10 - 1000000);
+  if (id_it != id_index.end())
+    idxs.push_back(id_it->second);
+
+  // Values within the FUZZY_WEIGHT ratio window (or equal), widened by a
+  // rounding margin since scoring decides
+  auto year_it = value_index.find(div.obs[0].year);
+  if (year_it != value_index.end()) {
+    const std::vector<double> &vars = div.obs[0].vars;
+    for (int k = 0; k < value_vars.size(); k++) {
+      const double value = vars[value_vars[k].second];
+      if (value == EMPTY_NUM)
+        continue;
+
+      const double tolerance = (1 + FUZZY_WEIGHT) * (1 + 1e-9);
+      const double low = value > 0 ? value / tolerance : value;
+      const double high = value > 0 ? value * tolerance : value;
+      const auto &sorted = year_it->second[k];
+      auto first = std::lower_bound(sorted.begin(), sorted.end(),
+                                    std::make_pair(low, -1));
+      auto last = std::upper_bound(sorted.begin(), sorted.end(),
+                                   std::make_pair(high, (int)base_divs.size()));
+      for (auto it = first; it != last; it++) {
+        idxs.push_back(it->second);
+      }
+    }
+  }
+
+  std::sort(idxs.begin(), idxs.end());
+  idxs.erase(std::unique(idxs.begin(), idxs.end()), idxs.end());
+
+  return idxs;
+}
+
+int MatchIndex::get_base_ob_idx(const Division &base, const int year) {
+  int base_ob_idx = -1;
+  for (int i = 0; i < base.obs.size(); i++) {
+    if (base.obs[i].year < year)
+      base_ob_idx = i;
+  }
+
+  return base_ob_idx;
+}
+
+} // namespace plan_database
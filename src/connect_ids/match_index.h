@@ -0,0 +1,46 @@
+#include "../lib/db.h"
+#include "../lib/similarity.h"
+#include <array>
+#include <cmath>
+#include <set>
+
+namespace plan_database {
+
+const std::set<std::string> name_stopwords = {
+    "AB", "BRUK", "ABB", "CO", "&", "STORA", "SVENSKA",
+}; // Name tokens too common to indicate a match
+
+// Signature of the folded name tokens of all observations, without stopwords
+similarity::Signature get_name_signature(const Division &div);
+
+// Blocking index over the divisions to connect to, built once: name 3-grams
+// (signature bits), converted IDs and, per first year of a division to
+// connect, the values of the last observation before it (X2, X5, X8) sorted.
+// candidates() returns the indices of the divisions that can score above zero.
+class MatchIndex {
+public:
+  const std::vector<Division> &base_divs;
+  std::vector<similarity::Signature> name_signatures; // per base division
+
+  MatchIndex(const std::vector<Division> &_base_divs,
+             const std::vector<Division> &to_connect);
+
+  std::vector<int> candidates(const Division &div,
+                              const similarity::Signature &div_sig) const;
+
+  // Index of the last observation of base before year (-1 if none)
+  static int get_base_ob_idx(const Division &base, const int year);
+
+private:
+  // (base variable, variable of the division to connect) compared in scoring
+  static constexpr std::array<std::pair<int, int>, 3> value_vars = {
+      {{7, 6}, {4, 3}, {1, 0}}};
+
+  std::vector<std::vector<int>> ngram_index; // per signature bit
+  std::map<int, int> id_index;
+  // Per year: (value, base index) sorted, per value_vars
+  std::map<int, std::array<std::vector<std::pair<double, int>>, 3>>
+      value_index;
+};
+
+} // namespace plan_database
@@ -1,4 +1,7 @@
 #!/bin/bash
-g++ -O2 -std=c++17 -o run connect_ids.cpp ../lib/db.cpp ../lib/plandata.cpp ../lib/division.cpp ../lib/csv.cpp ../lib/macro.cpp ../lib/utility.cpp
-./run
+# Arguments are passed on: --batch (link without prompting), --review (only
+# prompt for ambiguous divisions) or --apply (only apply the journal), see
+# connect_ids.h
+g++ -O2 -std=c++17 -pthread -o run connect_ids.cpp match_index.cpp ../lib/db.cpp ../lib/plandata.cpp ../lib/division.cpp ../lib/csv.cpp ../lib/macro.cpp ../lib/utility.cpp ../lib/pool.cpp ../lib/journal.cpp ../lib/linkage.cpp ../lib/similarity.cpp
+./run "$@"
 rm run
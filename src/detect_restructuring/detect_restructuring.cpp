@@ -2,45 +2,113 @@
 
 namespace plan_database {
 
-void detect_restructuring(PlanData &plandata) {
-  std::cout << "=========================== Organizational Restructures "
-               "==========================="
-            << std::endl
-            << std::endl;
-  std::cout << "ID\tYEAR\tVARIABLE\t\t\t\tNAME" << std::endl;
-  std::cout << "---------------------------------------------------------------"
-               "--------------------"
-            << std::endl;
+std::vector<Event> detect_division(const Division &div,
+                                   const std::vector<int> &var_idxs) {
+  std::vector<Event> events;
 
-  for (const auto &div : plandata.divs) {
-
-    double prev_val = div.obs[0].vars[VAR_IDX];
-    if (prev_val == EMPTY_NUM)
-      continue;
-
-    for (const auto &ob : div.obs) {
-
-      double val = ob.vars[VAR_IDX];
+  for (const int var_idx : var_idxs) {
+    // Changes between consecutive known values (NA observations are skipped,
+    // not the division)
+    std::vector<Event> changes;
+    int prev_idx = -1;
+    for (int i = 0; i < div.obs.size(); i++) {
+      const double val = div.obs[i].vars[var_idx];
       if (val == EMPTY_NUM)
         continue;
 
-      double change = val / prev_val;
+      if (prev_idx >= 0) {
+        const Division::Observation &prev = div.obs[prev_idx];
+        const double prev_val = prev.vars[var_idx];
+
+        Event change = {div.id,          div.obs[i].year, prev.year, var_idx,
+                        div.obs[i].name, prev_val,        val};
+        if (prev_val != 0)
+          change.ratio = val / prev_val;
+        if (prev_val > 0 && val > 0)
+          change.log_diff = std::log(val) - std::log(prev_val);
+        changes.push_back(change);
+      }
+      prev_idx = i;
+    }
+
+    // Robust z-scores of the log-differences
+    std::vector<double> log_diffs;
+    for (const Event &change : changes) {
+      if (change.log_diff != NA)
+        log_diffs.push_back(change.log_diff);
+    }
+    double center = NA, scale = NA;
+    if (log_diffs.size() >= MIN_Z_CHANGES) {
+      std::tie(center, scale) = median_mad(log_diffs);
+    }
 
-      if (std::abs(change) > THRESHOLD) {
-        std::cout << div.id << "\t" << ob.year << "\tX" << VAR_IDX + 1 << " ("
-                  << change * 100 << "%)\t" << prev_val << " -> " << val
-                  << "\t\t" << ob.name << std::endl;
+    for (Event &change : changes) {
+      if (change.ratio != NA &&
+          (std::abs(change.ratio) > RATIO_THRESHOLD ||
+           std::abs(change.ratio) < 1.0 / RATIO_THRESHOLD))
+        change.rules |= RATIO;
+      if (change.log_diff != NA &&
+          std::abs(change.log_diff) > LOG_DIFF_THRESHOLD)
+        change.rules |= LOG_DIFF;
+      if (change.log_diff != NA && scale != NA && scale > 0) {
+        change.robust_z = (change.log_diff - center) / scale;
+        if (std::abs(change.robust_z) > Z_THRESHOLD &&
+            std::abs(change.log_diff) >= MIN_Z_LOG_DIFF)
+          change.rules |= ROBUST_Z;
       }
 
-      prev_val = val;
+      if (change.rules)
+        events.push_back(change);
     }
   }
 
-  std::cout << std::endl
-            << "==============================================================="
-               "=========="
-               "=========="
-            << std::endl;
+  return events;
+}
+
+std::vector<Event> detect_restructuring(const PlanData &plandata,
+                                        const std::vector<int> &var_idxs) {
+  std::vector<std::vector<Event>> div_events(plandata.divs.size());
+
+  ThreadPool pool(N_THREADS);
+  pool.parallel_for((int)plandata.divs.size(), [&](int i) {
+    div_events[i] = detect_division(plandata.divs[i], var_idxs);
+  });
+
+  // In division order
+  std::vector<Event> events;
+  for (const std::vector<Event> &e : div_events) {
+    events.insert(events.end(), e.begin(), e.end());
+  }
+
+  return events;
+}
+
+void write_events(const std::vector<Event> &events, const std::string &path) {
+  auto num = [](const double d) { return d == NA ? EMPTY : csv::dtostr(d); };
+
+  std::vector<std::vector<std::string>> rows;
+  for (const Event &e : events) {
+    std::string rules;
+    if (e.rules & RATIO)
+      rules += "ratio ";
+    if (e.rules & LOG_DIFF)
+      rules += "log_diff ";
+    if (e.rules & ROBUST_Z)
+      rules += "robust_z ";
+    rules.pop_back();
+
+    std::string name = e.name;
+    name.erase(std::remove(name.begin(), name.end(), ','), name.end());
+
+    rows.push_back({std::to_string(e.id), name, std::to_string(e.prev_year),
+                    std::to_string(e.year), "X" + std::to_string(e.var_idx + 1),
+                    num(e.prev_value), num(e.value), num(e.ratio),
+                    num(e.log_diff), num(e.robust_z), rules});
+  }
+
+  csv::write(path, rows, ',',
+             {"id", "name", "prev_year", "year", "variable", "prev_value",
+              "value", "ratio", "log_diff", "robust_z", "rules"});
 }
 
 } // namespace plan_database
@@ -49,7 +117,24 @@ int main() {
   plan_database::Database db;
   db.plandata.parse_csv("../data/plan1975-2000-full.csv", ',', true);
 
-  plan_database::detect_restructuring(db.plandata);
+  std::vector<int> var_idxs = selected_vars;
+  if (var_idxs.empty()) {
+    for (int i = 0; i < db.plandata.divs[0].obs[0].vars.size(); i++) {
+      var_idxs.push_back(i);
+    }
+  }
+
+  const std::vector<plan_database::Event> events =
+      plan_database::detect_restructuring(db.plandata, var_idxs);
+  plan_database::write_events(events, EVENTS_PATH);
+
+  std::set<int> ids;
+  for (const plan_database::Event &e : events) {
+    ids.insert(e.id);
+  }
+  std::cout << "Wrote " << events.size() << " restructuring events ("
+            << ids.size() << " divisions, " << var_idxs.size()
+            << " variables) to " << EVENTS_PATH << std::endl;
 
   return 0;
 }
@@ -1,12 +1,47 @@
 #include "../lib/db.h"
+#include "../lib/pool.h"
+#include <cmath>
+#include <set>
+#include <tuple>
 
-#define VAR_IDX 1 // Variable (index) to analyse for restructuring
-#define THRESHOLD                                                              \
-  2 // Threshold, as the variable's relative difference between two years to
-    // identify as restructuring
+// Parameters
+const std::vector<int> selected_vars = {
+    1, // anställda
+}; // Variables (0-indexed) to scan for restructuring, empty: all 65
+#define RATIO_THRESHOLD                                                        \
+  2 // Ratio between two consecutive known values (either way) to identify as
+    // restructuring
+#define LOG_DIFF_THRESHOLD                                                     \
+  0.5 // Absolute log-difference between two consecutive known (positive)
+      // values to identify as restructuring
+#define Z_THRESHOLD                                                            \
+  3.5 // Robust z-score (median and MAD of the division's log-differences of
+      // the variable) to identify as restructuring
+#define MIN_Z_CHANGES 5 // Minimum number of log-differences for z-scores
+#define MIN_Z_LOG_DIFF                                                         \
+  0.2 // Minimum absolute log-difference identified by z-score (smooth series
+      // have tiny MADs)
+#define N_THREADS 0     // Threads scanning divisions (0: all hardware threads)
+#define EVENTS_PATH "restructuring_events.csv"
 
 namespace plan_database {
 
-void detect_restructuring(PlanData &plandata);
+enum Rule { RATIO = 1, LOG_DIFF = 2, ROBUST_Z = 4 }; // Bits of Event::rules
+
+// Change of a variable between two consecutive known values of a division
+// that at least one rule identifies as restructuring
+struct Event {
+  int id, year, prev_year, var_idx;
+  std::string name;
+  double prev_value, value;
+  double ratio = NA, log_diff = NA, robust_z = NA; // NA if undefined
+  int rules = 0;
+};
+
+std::vector<Event> detect_division(const Division &div,
+                                   const std::vector<int> &var_idxs);
+std::vector<Event> detect_restructuring(const PlanData &plandata,
+                                        const std::vector<int> &var_idxs);
+void write_events(const std::vector<Event> &events, const std::string &path);
 
 } // namespace plan_database
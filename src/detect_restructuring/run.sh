@@ -1,4 +1,4 @@
 #!/bin/bash
-g++ -O2 -std=c++17 -o run detect_restructuring.cpp ../lib/db.cpp ../lib/plandata.cpp ../lib/division.cpp ../lib/csv.cpp ../lib/macro.cpp ../lib/utility.cpp
+g++ -O2 -std=c++17 -pthread -o run detect_restructuring.cpp ../lib/db.cpp ../lib/plandata.cpp ../lib/division.cpp ../lib/csv.cpp ../lib/macro.cpp ../lib/utility.cpp ../lib/pool.cpp
 ./run
 rm run
@@ -1,8 +1,10 @@
 //
 //
 // NOTE:
-// The firm conversion catch for if employment is less than 0 was disabled when
-// running this program (labor irrelevant for the coverage_va graph)
+// Coverage of every measure, market and year is computed at once from the
+// survey sums and the macro table (see lib/coverage.h) and written to
+// COVERAGE_PATH; the charts plot the total shares of labor and value added.
+// Observations with NA in a measure's variables are left out of its sums.
 //
 //
 
@@ -11,58 +13,14 @@
 
 namespace plan_database {
 
-void draw_coverage(Database &db, int var) {
-  std::vector<int> required_var_idxs;
-  std::string y_axis_name;
-  std::string path;
-  if (var == LABOR) {
-    required_var_idxs = {1};
-    y_axis_name = "Labor (% of Swedish manufacturing)";
-    path = "coverage_l";
-  } else if (var == VALUEADDED) {
-    required_var_idxs = {7, 10, 16, 19, 22};
-    y_axis_name = "Value-added (% of Swedish manufacturing)";
-    path = "coverage_va";
-  } else
-    throw std::runtime_error("Invalid 'var' argument.");
-
+void draw_coverage(const Coverage &coverage, const Coverage::Measure measure,
+                   const std::string &y_axis_name, const std::string &path) {
   std::vector<Graph::Point> points;
-  for (int year = LOW; year <= MAX_YEAR; year++) {
-    std::vector<Firm> real_firms =
-        Firm::to_real_firms(db.plandata, {year}, required_var_idxs);
-    std::vector<Firm> synthetic_firms = Firm::to_synthetic_firms(
-        db.plandata, db.macrodata, real_firms, false, {year});
-    Firm residual_firm = synthetic_firms[0];
-
-    double sum = 0.0;
-    for (const Firm &firm : real_firms) {
-      for (const Firm::Observation &ob : firm.obs) {
-        if (ob.year != year)
-          continue;
-
-        if (var == LABOR)
-          sum += ob.employees;
-        else if (var == VALUEADDED)
-          sum += ob.sales - ob.input_cost;
-      }
-    }
-
-    double macro = 0.0;
-    for (const Firm::Observation &ob : residual_firm.obs) {
-      if (ob.year == year) {
-
-        if (var == LABOR)
-          macro = ob.employees;
-        else if (var == VALUEADDED)
-          macro = ob.sales - ob.input_cost;
-
-        break;
-      }
-    }
-
-    double total = sum + macro;
-    double coverage = 100 * sum / total;
-    points.push_back(Graph::Point(year, coverage));
+  for (int year = std::max(LOW, coverage.year_low);
+       year <= std::min(MAX_YEAR, coverage.year_high); year++) {
+    const double share = coverage.get(year, Coverage::ALL_MKTS, measure).share;
+    if (share != NA)
+      points.push_back(Graph::Point(year, share));
   }
 
   Graph::Serie serie = Graph::Serie(points);
@@ -75,14 +33,22 @@ void draw_coverage(Database &db, int var) {
 } // namespace plan_database
 
 int main(int argc, char *argv[]) {
+  plan_database::Graph::use_offscreen_platform();
   QApplication app(argc, argv);
 
   plan_database::Database db;
   db.plandata.parse_csv("../data/plan1975-2000.csv", ';', true);
   db.macrodata.parse_csv("../data/macrodatabase.csv");
 
-  plan_database::draw_coverage(db, LABOR);
-  plan_database::draw_coverage(db, VALUEADDED);
+  const plan_database::Coverage coverage(db.plandata, db.macrodata);
+  coverage.write_csv(COVERAGE_PATH);
+
+  plan_database::draw_coverage(coverage, plan_database::Coverage::EMPLOYEES,
+                               "Labor (% of Swedish manufacturing)",
+                               "coverage_l");
+  plan_database::draw_coverage(coverage, plan_database::Coverage::VALUE_ADDED,
+                               "Value-added (% of Swedish manufacturing)",
+                               "coverage_va");
 
   return 0;
 }
@@ -1,14 +1,14 @@
+#include "../lib/coverage.h"
 #include "../lib/db.h"
-#include "../lib/firm.h"
 #include "../lib/graph.h"
 #include "../lib/utility.h"
 
 #define LOW 1980
-#define LABOR 0
-#define VALUEADDED 1
+#define COVERAGE_PATH "coverage.csv" // Coverage of all measures and markets
 
 namespace plan_database {
 
-void draw_coverage(Database &db, int var);
+void draw_coverage(const Coverage &coverage, const Coverage::Measure measure,
+                   const std::string &y_axis_name, const std::string &path);
 
 } // namespace plan_database
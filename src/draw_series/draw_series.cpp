@@ -13,76 +13,54 @@
 namespace plan_database {
 
 void draw_series(Database db) {
-  double base_s = 0.0, base_va = 0.0, base_l = 0.0;
-  double macro_base_s = 0.0, macro_base_va = 0.0, macro_base_l = 0.0;
-
-  std::vector<Graph::Point> points, macro_points;
-  for (int year = LOW; year <= MAX_YEAR; year++) {
-    std::vector<Firm> real_firms = Firm::to_real_firms(db.plandata, {year});
-    std::vector<Firm> synthetic_firms = Firm::to_synthetic_firms(
-        db.plandata, db.macrodata, real_firms, false, {year});
-    Firm residual_firm = synthetic_firms[0];
-
-    double sum_s = 0.0, sum_va = 0.0, sum_l = 0.0;
-    for (const Firm &firm : real_firms) {
-      for (const Firm::Observation &ob : firm.obs) {
-        if (ob.year != year)
-          continue;
-
-        sum_s += ob.sales;
-        sum_va += ob.sales - ob.input_cost;
-        sum_l += ob.employees;
-      }
-    }
-
-    double res_s = 0.0, res_va = 0.0, res_l = 0.0;
-    for (const Firm::Observation &ob : residual_firm.obs) {
-      if (ob.year == year) {
-        res_s += ob.sales;
-        res_va = ob.sales - ob.input_cost;
-        res_l = ob.employees;
-        break;
-      }
-    }
-
-    if (year == LOW) {
-      base_s = sum_s / sum_l;
-      base_va = sum_va / sum_l;
-      macro_base_s = (res_s + sum_s) / (res_l + sum_l);
-      macro_base_va = (res_va + sum_va) / (res_l + sum_l);
+  // Cross-sections with one residual firm per year, as in the coverage charts
+  FirmPanel panel =
+      FirmPanel::from_cross_sections(db.plandata, db.macrodata, false);
+  DerivedVariables derived;
+
+  IndexSeries index_series(panel, derived, LOW, LOW);
+  index_series.write_csv(SERIES_PATH);
+
+  auto to_points = [&index_series](const std::vector<double> &values) {
+    std::vector<Graph::Point> points;
+    for (int year = index_series.year_low; year <= index_series.year_high;
+         year++) {
+      const double value = values[year - index_series.year_low];
+      if (value != NA)
+        points.push_back(Graph::Point(year, value));
     }
-
-    double relative_s = 100 * (sum_s / sum_l) / base_s;
-    double relative_va = 100 * (sum_va / sum_l) / base_va;
-    double relative_macro_s =
-        100 * (sum_s + res_s) / (sum_l + res_l) / macro_base_s;
-    double relative_macro_va =
-        100 * (sum_va + res_va) / (sum_l + res_l) / macro_base_va;
-
-    double s = 1e-6 * (sum_s / sum_l);
-    double va = 1e-6 * (sum_va / sum_l);
-    double macro_s = 1e-6 * (sum_s + res_s) / (sum_l + res_l);
-    double macro_va = 1e-6 * (sum_va + res_va) / (sum_l + res_l);
-
-    points.push_back(Graph::Point(year, relative_va));
-    macro_points.push_back(Graph::Point(year, relative_macro_va));
+    return points;
+  };
+
+  for (const std::string &metric : CHART_METRICS) {
+    const IndexSeries::Series &survey =
+        index_series.get(metric, IndexSeries::SURVEY);
+    const IndexSeries::Series &macro =
+        index_series.get(metric, IndexSeries::MACRO);
+
+    std::vector<Graph::Point> points = to_points(survey.fixed_base),
+                              chain_points = to_points(survey.chain_linked),
+                              macro_points = to_points(macro.fixed_base);
+    Graph::Serie serie = Graph::Serie(points, "Planning Survey firms");
+    Graph::Serie chain_serie =
+        Graph::Serie(chain_points, "Planning Survey firms (chain-linked)");
+    Graph::Serie macro_serie =
+        Graph::Serie(macro_points, "Swedish Manufacturing");
+
+    Graph graph =
+        Graph(metric + " - Planning Survey and Swedish Manufacturing", "Year",
+              metric + " (index " + std::to_string(LOW) + " = 100)",
+              {serie, chain_serie, macro_serie});
+
+    QChart *chart = graph.create_chart({LOW, MAX_YEAR});
+    Graph::export_chart("series_" + metric + "_index", chart);
   }
-
-  Graph::Serie serie = Graph::Serie(points, "Planning Survey firms");
-  Graph::Serie macro_serie =
-      Graph::Serie(macro_points, "Swedish Manufacturing");
-
-  Graph graph = Graph(
-      "Productivity Value - Planning Survey and Swedish Manufacturing", "Year",
-      "Productivity value per employee (index = 1980)", {serie, macro_serie});
-
-  QChart *chart = graph.create_chart({LOW, MAX_YEAR});
-  Graph::export_chart("series_va_index", chart);
 }
 
 } // namespace plan_database
 
 int main(int argc, char *argv[]) {
+  plan_database::Graph::use_offscreen_platform();
   QApplication app(argc, argv);
 
   plan_database::Database db;
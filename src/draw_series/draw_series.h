@@ -1,9 +1,14 @@
 #include "../lib/db.h"
+#include "../lib/derived.h"
 #include "../lib/firm.h"
 #include "../lib/graph.h"
+#include "../lib/index_series.h"
+#include "../lib/panel.h"
 #include "../lib/utility.h"
 
-#define LOW 1980
+#define LOW 1980 // Base year of the indices
+#define SERIES_PATH "series.csv"
+#define CHART_METRICS {"productivity", "sales_per_employee"}
 
 namespace plan_database {
 
@@ -1,7 +1,7 @@
 #!/bin/bash
 
 # macOS Qt6 framework build script
-QT_PATH="/opt/homebrew/opt/qt6"
+QT_PATH="${QT_PATH:-/opt/homebrew/opt/qt6}" # Override with QT_PATH=<path> ./run.sh
 
 # Check if Qt6 exists
 if [ ! -d "$QT_PATH" ]; then
@@ -20,13 +20,15 @@ g++ -std=c++17 -O2 \
   -I$QT_PATH/include/QtCharts \
   -I$QT_PATH/include/QtGui \
   -I$QT_PATH/include/QtPrintSupport \
-  draw_series.cpp ../lib/db.cpp ../lib/plandata.cpp ../lib/macro.cpp ../lib/division.cpp ../lib/csv.cpp ../lib/firm.cpp ../lib/graph.cpp ../lib/utility.cpp \
+  -I$QT_PATH/include/QtSvg \
+  draw_series.cpp ../lib/db.cpp ../lib/plandata.cpp ../lib/macro.cpp ../lib/division.cpp ../lib/csv.cpp ../lib/firm.cpp ../lib/panel.cpp ../lib/derived.cpp ../lib/index_series.cpp ../lib/salter.cpp ../lib/graph.cpp ../lib/utility.cpp \
   -F$QT_PATH/lib \
   -framework QtCore \
   -framework QtWidgets \
   -framework QtCharts \
   -framework QtGui \
   -framework QtPrintSupport \
+  -framework QtSvg \
   -rpath $QT_PATH/lib \
   -o draw_series
 
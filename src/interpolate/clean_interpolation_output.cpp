@@ -2,104 +2,76 @@
 
 namespace plan_database {
 
-void clean_interpolation_output(PlanData &base_data, PlanData &interp_data) {
+void clean_division(Division &base_div, const Division &interp_div,
+                    std::ostream &log) {
   for (const int idx : selected_vars) {
-    for (int div_idx = 0; div_idx < base_data.divs.size(); div_idx++) {
 
-      // 1. Find interval to only overwrite between end values that are not NA
-      // ("easy" interval) if ONLY_FILL_BETWEEN
-      int ob_idx_low = -1, ob_idx_high = -1;
-      if (ONLY_FILL_BETWEEN) {
+    // 1. Variables that are NA in all observations have no interval to fill
+    // between if ONLY_FILL_BETWEEN
+    if (!ONLY_FILL_BETWEEN)
+      break;
 
-        // Find ob_idx_low
-        for (int ob_idx = 0; ob_idx < base_data.divs[div_idx].obs.size();
-             ob_idx++) {
-          if (base_data.divs[div_idx].obs[ob_idx].vars[idx] != EMPTY_NUM) {
-            ob_idx_low = ob_idx;
-            break;
-          }
-        }
-
-        // Find ob_idx_high
-        for (int ob_idx = base_data.divs[div_idx].obs.size() - 1; ob_idx >= 0;
-             ob_idx--) {
-          if (base_data.divs[div_idx].obs[ob_idx].vars[idx] != EMPTY_NUM) {
-            ob_idx_high = ob_idx;
-            break;
-          }
-        }
-
-      } else {
-        ob_idx_low = 0;
-        ob_idx_high = base_data.divs[div_idx].obs.size();
+    bool all_na = true;
+    for (const auto &ob : base_div.obs) {
+      if (ob.vars[idx] != EMPTY_NUM) {
+        all_na = false;
+        break;
       }
+    }
 
-      if (ob_idx_low == -1 || ob_idx_high == -1) {
-        std::cerr
-            << "ERROR: Could not find ob_idx_low or ob_idx_high (all vars "
-               "are NA): "
-            << "{ id: " << base_data.divs[div_idx].id << ", var: X" << idx + 1
-            << " }" << std::endl;
-
-        // If error in trying to interpolate a division that is in the desired
-        // interval, throw an exception
-        if (base_data.divs[div_idx].in_interval(LOW, HIGH)) {
-          throw std::runtime_error(
-              std::string("ERROR: Could not find ob_idx_low or ob_idx_high for "
-                          "division IN "
-                          "THE SELECTED INTERVAL (all vars are NA): ") +
-              " {id : " + std::to_string(base_data.divs[div_idx].id) +
-              ", var: X" + std::to_string(idx + 1) + " }\n");
-        }
+    if (all_na) {
+      log << "ERROR: Could not find ob_idx_low or ob_idx_high (all vars "
+             "are NA): "
+          << "{ id: " << base_div.id << ", var: X" << idx + 1 << " }"
+          << std::endl;
+
+      // If error in trying to interpolate a division that is in the desired
+      // interval, throw an exception
+      if (base_div.in_interval(LOW, HIGH)) {
+        throw std::runtime_error(
+            std::string("ERROR: Could not find ob_idx_low or ob_idx_high for "
+                        "division IN "
+                        "THE SELECTED INTERVAL (all vars are NA): ") +
+            " {id : " + std::to_string(base_div.id) + ", var: X" +
+            std::to_string(idx + 1) + " }\n");
       }
+    }
+  }
 
-      // 2. Overwrite NA-values with interpolated values in interval
-      for (int ob_idx = 0; ob_idx < base_data.divs[div_idx].obs.size();
-           ob_idx++) {
-        if (base_data.divs[div_idx].obs[ob_idx].vars[idx] == EMPTY_NUM &&
-            interp_data.divs[div_idx].obs[ob_idx].vars[idx] != EMPTY_NUM) {
-
-          double interpolated_value =
-              interp_data.divs[div_idx].obs[ob_idx].vars[idx];
-          if (interpolated_value < 0) {
-            std::cerr << "WARNING: Negative interpolated value: " +
-                             std::to_string(interpolated_value);
-          }
-
-          base_data.divs[div_idx].obs[ob_idx].vars[idx] = interpolated_value;
-        }
-      }
+  // 2. Overwrite NA-values with interpolated values of the same year (only
+  // between end values that are not NA if ONLY_FILL_BETWEEN)
+  for (const auto &[ob_idx, idx] :
+       base_div.overlay(interp_div, selected_vars, ONLY_FILL_BETWEEN)) {
+    const double interpolated_value = base_div.obs[ob_idx].vars[idx];
+    if (interpolated_value < 0) {
+      log << "WARNING: Negative interpolated value: " +
+                 std::to_string(interpolated_value);
     }
   }
 
   // Make number of employee values integers
-  for (auto &div : base_data.divs) {
-    for (auto &ob : div.obs) {
-      ob.vars[0] = (int)ob.vars[0];
-      ob.vars[1] = (int)ob.vars[1];
-      ob.vars[2] = (int)ob.vars[2];
+  for (auto &ob : base_div.obs) {
+    ob.vars[0] = (int)ob.vars[0];
+    ob.vars[1] = (int)ob.vars[1];
+    ob.vars[2] = (int)ob.vars[2];
+  }
+}
+
+void clean_interpolation_output(PlanData &base_data,
+                                const PlanData &interp_data) {
+  // Divisions are matched by id, divisions without interpolated data are only
+  // checked
+  const auto pairs = base_data.join_divs(interp_data);
+  int pair_idx = 0;
+  for (int div_idx = 0; div_idx < base_data.divs.size(); div_idx++) {
+    Division &base_div = base_data.divs[div_idx];
+    if (pair_idx < pairs.size() && pairs[pair_idx].first == div_idx) {
+      clean_division(base_div, interp_data.divs[pairs[pair_idx++].second],
+                     std::cerr);
+    } else {
+      clean_division(base_div, Division(base_div.id), std::cerr);
     }
   }
 }
 
 } // namespace plan_database
-
-int main() {
-
-  // Base database to overwrite with interpolated values
-  plan_database::Database db_base;
-  db_base.plandata.parse_csv("interpolation_input.csv", ',', true);
-
-  // Database with interpolated values
-  plan_database::Database db_interp;
-  db_interp.plandata.parse_csv("interpolation_output.csv", ',', true);
-
-  // Overwrite NA-values in the base database with interpolated values
-  plan_database::clean_interpolation_output(db_base.plandata,
-                                            db_interp.plandata);
-
-  // Write updated base database
-  db_base.plandata.write_csv("interpolated.csv", ',', true);
-
-  return 0;
-}
@@ -17,6 +17,9 @@ const std::vector<int> selected_vars = {
 
 namespace plan_database {
 
-void clean_interpolation_output(PlanData &base_data, PlanData &interp_data);
+void clean_division(Division &base_div, const Division &interp_div,
+                    std::ostream &log);
+void clean_interpolation_output(PlanData &base_data,
+                                const PlanData &interp_data);
 
 } // namespace plan_database
@@ -0,0 +1,219 @@
+//
+//
+// NOTE:
+// Interpolation of the planning survey, in one process: prepare the input
+// (missing years, historic values, totals), interpolate the selected
+// variables with the method of their set in method_vars and overwrite only
+// NA values. Divisions are independent and go through all steps at once, in
+// parallel; output and log order do not depend on the number of threads.
+//
+// The output of each division is cached in CACHE_PATH, keyed by the hash of
+// its input and the parameters. On the next run only divisions whose input
+// (or the parameters) changed are recomputed.
+//
+// With COMPARE, every method's value of every filled cell is written to
+// interpolation_comparison.csv, and each method's hold-out error (known
+// values between two other known values left out and re-interpolated) is
+// printed.
+//
+//
+
+#include "interpolate.h"
+
+namespace plan_database {
+
+std::string cache_params() {
+  // Everything besides the input division that the output depends on
+  std::ostringstream params;
+  params << "version=" << CACHE_VERSION << ";low=" << LOW << ";high=" << HIGH
+         << ";only_fill_between=" << ONLY_FILL_BETWEEN << ";selected=";
+  for (const int var : selected_vars) {
+    params << var << " ";
+  }
+  for (const auto &[method, var_idxs] : method_vars) {
+    params << ";" << interpolation::method_names[method] << "=";
+    for (const int var : var_idxs) {
+      params << var << " ";
+    }
+  }
+
+  return params.str();
+}
+
+void interpolate_divisions(PlanData &plandata, PlanData *prepared) {
+  const int n = (int)plandata.divs.size();
+  std::vector<std::string> logs(n), errors(n);
+  if (prepared != nullptr)
+    prepared->divs = plandata.divs;
+
+  // Cached output of unchanged divisions. Divisions that log warnings or errors
+  // are not cached, so that their messages show on every run.
+  const bool use_cache = std::string(CACHE_PATH) != "";
+  DivisionCache cache;
+  std::vector<uint64_t> keys(n);
+  std::vector<char> cacheable(n, false);
+  if (use_cache) {
+    cache.load(CACHE_PATH);
+    const std::string params = cache_params();
+    for (int i = 0; i < n; i++) {
+      keys[i] = DivisionCache::key(plandata.divs[i], params);
+    }
+  }
+  std::atomic<int> n_cached = 0;
+
+  ThreadPool pool(N_THREADS);
+  pool.parallel_for(n, [&](int i) {
+    Division &div = plandata.divs[i];
+    const Division *cached = use_cache ? cache.find(keys[i]) : nullptr;
+    std::ostringstream log;
+
+    try {
+      if (cached == nullptr || prepared != nullptr) {
+        prepare_division(div);
+        if (prepared != nullptr)
+          prepared->divs[i] = div;
+      }
+
+      if (cached != nullptr) {
+        div = *cached;
+        cacheable[i] = true;
+        n_cached++;
+        return;
+      }
+
+      // Interpolate a copy, to overwrite NA values in the base data with
+      Division interp_div = div;
+      for (const auto &[method, var_idxs] : method_vars) {
+        interpolation::interpolate(interp_div, var_idxs, method);
+      }
+
+      clean_division(div, interp_div, log);
+    } catch (const std::exception &e) {
+      errors[i] = e.what();
+    }
+
+    logs[i] = log.str();
+    cacheable[i] = logs[i].empty() && errors[i].empty();
+  });
+
+  // Logs in division order, then the first error
+  for (int i = 0; i < n; i++) {
+    std::cerr << logs[i];
+    if (!errors[i].empty())
+      throw std::runtime_error(errors[i]);
+  }
+
+  // Keep only the divisions of this run
+  if (use_cache) {
+    DivisionCache new_cache;
+    for (int i = 0; i < n; i++) {
+      if (cacheable[i])
+        new_cache.insert(keys[i], plandata.divs[i]);
+    }
+    new_cache.save(CACHE_PATH);
+
+    std::cout << "Interpolated " << n - n_cached << " divisions, "
+              << n_cached << " from cache" << std::endl;
+  }
+}
+
+void compare_methods(const PlanData &plandata,
+                     const std::vector<int> &var_idxs,
+                     const std::string &path) {
+  using namespace interpolation;
+
+  std::vector<std::vector<std::string>> rows;
+  double abs_error[N_METHODS] = {}, rel_error[N_METHODS] = {};
+  long n_held_out = 0, n_rel = 0;
+
+  std::vector<int> years;
+  std::vector<double> values, filled[N_METHODS];
+  for (const Division &div : plandata.divs) {
+    const int n = (int)div.obs.size();
+    years.resize(n);
+    for (int i = 0; i < n; i++) {
+      years[i] = div.obs[i].year;
+    }
+
+    for (const int var : var_idxs) {
+      values.resize(n);
+      std::vector<int> known;
+      for (int i = 0; i < n; i++) {
+        values[i] = div.obs[i].vars[var];
+        if (values[i] != EMPTY_NUM)
+          known.push_back(i);
+      }
+
+      // Filled cells
+      for (int method = 0; method < N_METHODS; method++) {
+        filled[method] = values;
+        fill(years, filled[method], (Method)method);
+      }
+      for (int i = 0; i < n; i++) {
+        if (values[i] != EMPTY_NUM || filled[0][i] == EMPTY_NUM)
+          continue;
+
+        std::vector<std::string> row = {std::to_string(div.id),
+                                        std::to_string(years[i]),
+                                        "X" + std::to_string(var + 1)};
+        for (int method = 0; method < N_METHODS; method++) {
+          row.push_back(csv::dtostr(filled[method][i]));
+        }
+        rows.push_back(row);
+      }
+
+      // Hold-out error of interior known values
+      for (int k = 1; k + 1 < (int)known.size(); k++) {
+        const int i = known[k];
+        const double truth = values[i];
+        values[i] = EMPTY_NUM;
+
+        for (int method = 0; method < N_METHODS; method++) {
+          filled[method] = values;
+          fill(years, filled[method], (Method)method);
+
+          abs_error[method] += std::abs(filled[method][i] - truth);
+          if (truth != 0)
+            rel_error[method] +=
+                std::abs(filled[method][i] - truth) / std::abs(truth);
+        }
+
+        values[i] = truth;
+        n_held_out++;
+        n_rel += truth != 0;
+      }
+    }
+  }
+
+  std::vector<std::string> header = {"id", "year", "var"};
+  header.insert(header.end(), method_names, method_names + N_METHODS);
+  csv::write(path, rows, ',', header);
+  std::cout << "Saved CSV: " << path << " (" << rows.size() << " cells)"
+            << std::endl;
+
+  for (int method = 0; method < N_METHODS; method++) {
+    std::cout << "Hold-out error: method: " << method_names[method]
+              << " mean_abs: " << abs_error[method] / std::max(n_held_out, 1L)
+              << " mean_rel: " << rel_error[method] / std::max(n_rel, 1L)
+              << " (n: " << n_held_out << ")" << std::endl;
+  }
+}
+
+} // namespace plan_database
+
+int main() {
+  plan_database::Database db;
+  db.plandata.parse_csv("../data/plan1975-2000.csv", ';', true);
+
+  plan_database::PlanData prepared;
+  plan_database::interpolate_divisions(db.plandata,
+                                       COMPARE ? &prepared : nullptr);
+
+  if (COMPARE)
+    plan_database::compare_methods(prepared, selected_vars,
+                                   "interpolation_comparison.csv");
+
+  db.plandata.write_csv("interpolated.csv", ',', true);
+
+  return 0;
+}
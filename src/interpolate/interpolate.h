@@ -0,0 +1,31 @@
+#include "../lib/db.h"
+#include "../lib/division_cache.h"
+#include "../lib/interpolation.h"
+#include "../lib/pool.h"
+#include "clean_interpolation_output.h"
+#include "prepare_interpolation_input.h"
+
+// Parameters
+#define N_THREADS 0 // Threads processing divisions (0: all hardware threads)
+#define COMPARE false // Compare all methods on selected_vars (writes csv)
+#define CACHE_PATH                                                             \
+  "interpolation_cache.csv" // Interpolated divisions of the last run, reused
+                            // for unchanged input ("": no cache)
+#define CACHE_VERSION 1 // Bump after changing fill, prepare_division or
+                        // clean_division (invalidates the cache)
+const std::vector<
+    std::pair<plan_database::interpolation::Method, std::vector<int>>>
+    method_vars = {
+        {plan_database::interpolation::LINEAR, selected_vars},
+}; // Interpolation method per set of variables (0-indexed), e.g. GROWTH for
+   // monetary variables: {plan_database::interpolation::GROWTH, {7, 10}}
+
+namespace plan_database {
+
+std::string cache_params();
+void interpolate_divisions(PlanData &plandata, PlanData *prepared = nullptr);
+void compare_methods(const PlanData &plandata,
+                     const std::vector<int> &var_idxs,
+                     const std::string &path);
+
+} // namespace plan_database
@@ -2,6 +2,7 @@
 
 namespace plan_database {
 
+void prepare_division(Division &div);
 void prepare_interpolation_input(PlanData &plandata);
 
 } // namespace plan_database
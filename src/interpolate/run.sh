@@ -1,20 +1,11 @@
 #!/bin/bash
 
-# Prepare interpolation input csv
-g++ -O2 -std=c++17 -o prepare_interpolation_input prepare_interpolation_input.cpp ../lib/db.cpp ../lib/plandata.cpp ../lib/division.cpp ../lib/csv.cpp ../lib/macro.cpp ../lib/utility.cpp
-./prepare_interpolation_input
-
-# Interpolate (R)
-Rscript interpolate.R
-
-# Clean up interpolation output (and only overwrite selected variables)
-g++ -O2 -std=c++17 -o clean_interpolation_output clean_interpolation_output.cpp ../lib/db.cpp ../lib/plandata.cpp ../lib/division.cpp ../lib/csv.cpp ../lib/macro.cpp ../lib/utility.cpp
-./clean_interpolation_output
-
-# Delete intermediary csv files
-rm interpolation_input.csv
-rm interpolation_output.csv
-
-# Delete binaries
-rm prepare_interpolation_input
-rm clean_interpolation_output
+# Prepare input, interpolate and clean up output (only overwrite selected
+# variables) in one process. Unchanged divisions are read from
+# interpolation_cache.csv (CACHE_PATH); delete it, or bump CACHE_VERSION, after
+# changing the interpolation code
+g++ -O2 -std=c++17 -pthread -o interpolate interpolate.cpp prepare_interpolation_input.cpp clean_interpolation_output.cpp ../lib/db.cpp ../lib/plandata.cpp ../lib/division.cpp ../lib/csv.cpp ../lib/macro.cpp ../lib/utility.cpp ../lib/interpolation.cpp ../lib/pool.cpp ../lib/division_cache.cpp
+./interpolate
+
+# Delete binary
+rm interpolate
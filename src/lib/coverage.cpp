@@ -0,0 +1,148 @@
+#include "coverage.h"
+
+namespace plan_database {
+
+double Coverage::get_survey_value(const std::vector<double> &vars,
+                                  const Measure measure) {
+  auto sum = [&vars](const std::vector<int> &var_idxs, const double scale) {
+    double ret = 0;
+    for (const int var : var_idxs) {
+      if (vars[var] == EMPTY_NUM)
+        return NA;
+      ret += vars[var];
+    }
+    return scale * ret;
+  };
+
+  switch (measure) {
+  case EMPLOYEES:
+    return sum({1}, 1);
+  case MANHOURS:
+    return sum({4}, 1e3);
+  case SALES:
+    return sum({7, 10}, 1e6);
+  case INPUT_COST:
+    return sum({16, 19, 22}, 1e6);
+  case VALUE_ADDED: {
+    const double sales = sum({7, 10}, 1e6);
+    const double input_cost = sum({16, 19, 22}, 1e6);
+    return sales == NA || input_cost == NA ? NA : sales - input_cost;
+  }
+  case WAGE_SUM:
+    return sum({25}, 1e6);
+  case GROSS_INVESTMENTS:
+    return sum({36}, 1e6);
+  default:
+    throw std::runtime_error("ERROR: Invalid coverage measure");
+  }
+}
+
+double Coverage::get_macro_value(const MacroData::Observation &ob,
+                                 const Measure measure) {
+  switch (measure) {
+  case EMPLOYEES:
+    return ob.employees;
+  case MANHOURS:
+    return ob.manhours;
+  case SALES:
+    return ob.sales;
+  case INPUT_COST:
+    return ob.input_cost;
+  case VALUE_ADDED:
+    return ob.sales == NA || ob.input_cost == NA ? NA
+                                                 : ob.sales - ob.input_cost;
+  case WAGE_SUM:
+    return ob.wage_sum;
+  case GROSS_INVESTMENTS:
+    return ob.gross_investments;
+  default:
+    throw std::runtime_error("ERROR: Invalid coverage measure");
+  }
+}
+
+int Coverage::index(const int year, const int mkt_id,
+                    const Measure measure) const {
+  return ((year - year_low) * (N_MKT_PLAN + 1) + mkt_id) * N_MEASURES +
+         measure;
+}
+
+Coverage::Coverage(const PlanData &plandata, const MacroData &macrodata)
+    : year_low(macrodata.year_low), year_high(macrodata.year_high) {
+  const int n_years = year_high - year_low + 1;
+  cells.assign(std::max(0, n_years) * (N_MKT_PLAN + 1) * N_MEASURES, Cell());
+
+  // Survey sums, one pass over all observations
+  for (const Division &div : plandata.divs) {
+    const int mkt_id = get_mkt_id(div.obs[0].industry);
+
+    for (const Division::Observation &ob : div.obs) {
+      if (ob.year < year_low || ob.year > year_high)
+        continue;
+
+      for (int m = 0; m < N_MEASURES; m++) {
+        const double value = get_survey_value(ob.vars, (Measure)m);
+        if (value == NA)
+          continue;
+
+        for (const int mkt : {mkt_id, ALL_MKTS}) {
+          Cell &cell = cells[index(ob.year, mkt, (Measure)m)];
+          cell.survey += value;
+          cell.n_obs++;
+        }
+      }
+    }
+  }
+
+  // Macro values and shares
+  for (int year = year_low; year <= year_high; year++) {
+    for (int mkt = 0; mkt <= ALL_MKTS; mkt++) {
+      const MacroData::Observation *mac_ob =
+          mkt == ALL_MKTS ? macrodata.get_total(year) : macrodata.get(year, mkt);
+      if (!mac_ob)
+        continue;
+
+      for (int m = 0; m < N_MEASURES; m++) {
+        Cell &cell = cells[index(year, mkt, (Measure)m)];
+        cell.macro = get_macro_value(*mac_ob, (Measure)m);
+        if (cell.macro != NA && cell.macro > 0)
+          cell.share = 100 * cell.survey / cell.macro;
+      }
+    }
+  }
+}
+
+const Coverage::Cell &Coverage::get(const int year, const int mkt_id,
+                                    const Measure measure) const {
+  if (year < year_low || year > year_high || mkt_id < 0 || mkt_id > ALL_MKTS)
+    throw std::runtime_error("ERROR: Coverage cell out of range (year: " +
+                             std::to_string(year) +
+                             " mkt_id: " + std::to_string(mkt_id) + ")");
+
+  return cells[index(year, mkt_id, measure)];
+}
+
+void Coverage::write_csv(const std::string &path) const {
+  auto num = [](const double d) { return d == NA ? EMPTY : csv::dtostr(d); };
+
+  std::vector<std::vector<std::string>> rows;
+  for (int year = year_low; year <= year_high; year++) {
+    for (int mkt = 0; mkt <= ALL_MKTS; mkt++) {
+      for (int m = 0; m < N_MEASURES; m++) {
+        const Cell &cell = cells[index(year, mkt, (Measure)m)];
+        if (cell.macro == NA && cell.n_obs == 0)
+          continue;
+
+        rows.push_back({std::to_string(year),
+                        mkt == ALL_MKTS ? "all" : get_industry_code(mkt),
+                        measure_names[m], num(cell.survey), num(cell.macro),
+                        num(cell.share), std::to_string(cell.n_obs)});
+      }
+    }
+  }
+
+  csv::write(path, rows, ',',
+             {"year", "industry", "measure", "survey", "macro", "share",
+              "n_obs"});
+}
+
+} // namespace plan_database
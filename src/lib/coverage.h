@@ -0,0 +1,60 @@
+#ifndef COVERAGE_H
+#define COVERAGE_H
+
+#include "macro.h"
+#include "plandata.h"
+#include "utility.h"
+#include <string>
+#include <vector>
+
+namespace plan_database {
+
+// Planning survey share of Swedish manufacturing (the macro table) per year
+// and market, for every measure at once, from one pass over the survey. An
+// observation adds to a measure only if the variables it needs are not NA.
+class Coverage {
+public:
+  enum Measure {
+    EMPLOYEES,         // X2
+    MANHOURS,          // X5
+    SALES,             // X8 + X11
+    INPUT_COST,        // X17 + X20 + X23
+    VALUE_ADDED,       // sales - input cost (not the macro value added)
+    WAGE_SUM,          // X26
+    GROSS_INVESTMENTS, // X37
+    N_MEASURES
+  };
+  static inline const std::string measure_names[N_MEASURES] = {
+      "employees", "manhours", "sales",           "input_cost",
+      "value_added", "wage_sum", "gross_investments"};
+
+  static constexpr int ALL_MKTS = N_MKT_PLAN; // market index of the totals
+
+  struct Cell {
+    double survey = 0, macro = NA, share = NA; // share: % (NA without macro)
+    int n_obs = 0; // survey observations in the sum
+  };
+
+  int year_low = 0, year_high = -1; // years of the macro table
+
+  Coverage(const PlanData &plandata, const MacroData &macrodata);
+
+  const Cell &get(const int year, const int mkt_id,
+                  const Measure measure) const;
+  void write_csv(const std::string &path) const;
+
+  // Survey value of a measure for one observation (NA if a variable is NA)
+  static double get_survey_value(const std::vector<double> &vars,
+                                 const Measure measure);
+  static double get_macro_value(const MacroData::Observation &ob,
+                                const Measure measure);
+
+private:
+  std::vector<Cell> cells; // ((year - year_low) * (N_MKT_PLAN + 1) + mkt_id)
+                           // * N_MEASURES + measure
+  int index(const int year, const int mkt_id, const Measure measure) const;
+};
+
+} // namespace plan_database
+
+#endif // COVERAGE_H
@@ -0,0 +1,98 @@
+#include "derived.h"
+
+namespace plan_database {
+
+DerivedVariables::DerivedVariables() {
+  add("value_added", {{FirmPanel::SALES, 1}, {FirmPanel::INPUT_COST, -1}});
+  add("productivity", {{FirmPanel::SALES, 1}, {FirmPanel::INPUT_COST, -1}},
+      FirmPanel::EMPLOYEES, 1e-6);
+  add("wage_cost", {{FirmPanel::WAGE_SUM, 1}}, FirmPanel::EMPLOYEES, 1e-6);
+  add("sales_per_employee", {{FirmPanel::SALES, 1}}, FirmPanel::EMPLOYEES,
+      1e-6);
+}
+
+void DerivedVariables::add(
+    const std::string &name,
+    const std::vector<std::pair<FirmPanel::Column, double>> &terms,
+    const int denominator, const double scale) {
+  if (terms.empty())
+    throw std::runtime_error("ERROR: Derived variable without terms: " + name);
+
+  for (Formula &formula : formulas) {
+    if (formula.name == name) {
+      formula = {name, terms, denominator, scale};
+      std::lock_guard<std::mutex> lock(cache_mutex);
+      for (auto it = cache.begin(); it != cache.end();) {
+        it = it->first.second == name ? cache.erase(it) : std::next(it);
+      }
+      return;
+    }
+  }
+
+  formulas.push_back({name, terms, denominator, scale});
+}
+
+const DerivedVariables::Formula &
+DerivedVariables::get_formula(const std::string &name) const {
+  for (const Formula &formula : formulas) {
+    if (formula.name == name)
+      return formula;
+  }
+
+  throw std::runtime_error("ERROR: Unknown derived variable: " + name);
+}
+
+const std::vector<double> &
+DerivedVariables::evaluate(const FirmPanel &panel, const std::string &name) {
+  const Formula &formula = get_formula(name);
+
+  std::lock_guard<std::mutex> lock(cache_mutex);
+  auto [it, is_new] = cache.try_emplace({panel.version, name});
+  if (is_new)
+    evaluate(panel, formula, it->second);
+
+  return it->second;
+}
+
+void DerivedVariables::evaluate(const FirmPanel &panel, const Formula &formula,
+                                std::vector<double> &out) {
+  const size_t n = panel.size();
+  out.resize(n);
+  double *__restrict dst = out.data();
+
+  // Plain loops over contiguous columns (auto-vectorised by the compiler)
+  {
+    const double *__restrict src =
+        panel.get_column(formula.terms[0].first).data();
+    const double w = formula.terms[0].second;
+    for (size_t i = 0; i < n; i++) {
+      dst[i] = w * src[i];
+    }
+  }
+
+  for (size_t t = 1; t < formula.terms.size(); t++) {
+    const double *__restrict src =
+        panel.get_column(formula.terms[t].first).data();
+    const double w = formula.terms[t].second;
+    for (size_t i = 0; i < n; i++) {
+      dst[i] += w * src[i];
+    }
+  }
+
+  if (formula.scale != 1.0) {
+    const double scale = formula.scale;
+    for (size_t i = 0; i < n; i++) {
+      dst[i] *= scale;
+    }
+  }
+
+  if (formula.denominator != NO_DENOMINATOR) {
+    const double *__restrict den =
+        panel.get_column((FirmPanel::Column)formula.denominator).data();
+    for (size_t i = 0; i < n; i++) {
+      dst[i] /= den[i];
+    }
+  }
+}
+
+} // namespace plan_database
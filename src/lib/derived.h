@@ -0,0 +1,53 @@
+#ifndef DERIVED_H
+#define DERIVED_H
+
+#include "panel.h"
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#define NO_DENOMINATOR -1
+
+namespace plan_database {
+
+// Derived variables over a firm panel. A formula is
+//   scale * (sum of weight * column) / denominator column
+// and is evaluated column-wise over every row of the panel in one pass.
+// Results are cached per (panel version, name) and are not recomputed while
+// the panel is unchanged, so references returned by evaluate stay valid for
+// the lifetime of this object, also when other panels are evaluated.
+class DerivedVariables {
+public:
+  struct Formula {
+    std::string name;
+    std::vector<std::pair<FirmPanel::Column, double>> terms; // numerator
+    int denominator = NO_DENOMINATOR;
+    double scale = 1.0;
+  };
+
+  std::vector<Formula> formulas;
+
+  DerivedVariables(); // Registers the default formulas
+
+  // Replacing a formula drops its cached values
+  void add(const std::string &name,
+           const std::vector<std::pair<FirmPanel::Column, double>> &terms,
+           const int denominator = NO_DENOMINATOR, const double scale = 1.0);
+  const Formula &get_formula(const std::string &name) const;
+
+  const std::vector<double> &evaluate(const FirmPanel &panel,
+                                      const std::string &name);
+  static void evaluate(const FirmPanel &panel, const Formula &formula,
+                       std::vector<double> &out);
+
+private:
+  std::map<std::pair<unsigned long, std::string>, std::vector<double>>
+      cache; // (panel version, name) -> values
+  std::mutex cache_mutex;
+};
+
+} // namespace plan_database
+
+#endif // DERIVED_H
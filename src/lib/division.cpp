@@ -123,6 +123,91 @@ void Division::filter_years(const std::vector<int> &years) {
   obs = std::move(filtered_obs);
 }
 
+std::vector<std::pair<int, int>>
+Division::join_obs(const Division &other) const {
+  auto assert_sorted = [](const Division &div) {
+    for (int i = 1; i < div.obs.size(); i++) {
+      if (div.obs[i - 1].year >= div.obs[i].year)
+        throw std::runtime_error(
+            "ERROR: Observations not sorted by unique year in join_obs(): "
+            "{ id: " +
+            std::to_string(div.id) +
+            ", year: " + std::to_string(div.obs[i].year) + " }");
+    }
+  };
+  assert_sorted(*this);
+  assert_sorted(other);
+
+  std::vector<std::pair<int, int>> pairs;
+  int i = 0, j = 0;
+  while (i < obs.size() && j < other.obs.size()) {
+    if (obs[i].year < other.obs[j].year) {
+      i++;
+    } else if (obs[i].year > other.obs[j].year) {
+      j++;
+    } else {
+      pairs.push_back({i++, j++});
+    }
+  }
+
+  return pairs;
+}
+
+std::vector<std::pair<int, int>>
+Division::overlay(const Division &other, const std::vector<int> &var_idxs,
+                  const bool only_between) {
+  // Observation interval to overwrite in, per variable
+  std::vector<int> lows(var_idxs.size(), 0),
+      highs(var_idxs.size(), (int)obs.size() - 1);
+  if (only_between) {
+    for (int k = 0; k < var_idxs.size(); k++) {
+      lows[k] = obs.size();
+      highs[k] = -1;
+      for (int ob_idx = 0; ob_idx < obs.size(); ob_idx++) {
+        if (obs[ob_idx].vars[var_idxs[k]] != EMPTY_NUM) {
+          lows[k] = std::min(lows[k], ob_idx);
+          highs[k] = ob_idx;
+        }
+      }
+    }
+  }
+
+  std::vector<std::pair<int, int>> cells;
+  for (const auto &[ob_idx, other_idx] : join_obs(other)) {
+    std::vector<double> &vars = obs[ob_idx].vars;
+    const std::vector<double> &other_vars = other.obs[other_idx].vars;
+
+    for (int k = 0; k < var_idxs.size(); k++) {
+      const int idx = var_idxs[k];
+      if (ob_idx < lows[k] || ob_idx > highs[k])
+        continue;
+
+      if (vars[idx] == EMPTY_NUM && other_vars[idx] != EMPTY_NUM) {
+        vars[idx] = other_vars[idx];
+        cells.push_back({ob_idx, idx});
+      }
+    }
+  }
+
+  return cells;
+}
+
+uint64_t Division::hash() const {
+  uint64_t h = fnv1a(&id, sizeof(id));
+  for (const Observation &ob : obs) {
+    h = fnv1a(&ob.year, sizeof(ob.year), h);
+    h = fnv1a(&ob.sni, sizeof(ob.sni), h);
+    h = fnv1a(ob.industry, h);
+    h = fnv1a(ob.code, h);
+    h = fnv1a(ob.name, h);
+    const uint64_t n_vars = ob.vars.size();
+    h = fnv1a(&n_vars, sizeof(n_vars), h);
+    h = fnv1a(ob.vars.data(), ob.vars.size() * sizeof(double), h);
+  }
+
+  return h;
+}
+
 Division::Observation
 Division::Observation::parse_tokens(const std::vector<std::string> &tokens,
                                     const bool full_data) {
@@ -2,8 +2,10 @@
 #define DIVISION_H
 
 #include "csv.h"
+#include "utility.h"
 #include <map>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace plan_database {
@@ -36,8 +38,19 @@ public:
                     const std::vector<int> &years = std::vector<int>()) const;
   bool has_year(const int year) const;
   void filter_years(const std::vector<int> &years);
+  // Index pairs (this, other) of observations with the same year, in one
+  // merge pass over both (sorted by year, see sort_obs())
+  std::vector<std::pair<int, int>> join_obs(const Division &other) const;
+  // Sets NA values of var_idxs to the non-NA values of other's observation of
+  // the same year. With only_between, only between the first and last non-NA
+  // value of each variable. Returns the overwritten cells (ob_idx, var_idx).
+  std::vector<std::pair<int, int>> overlay(const Division &other,
+                                           const std::vector<int> &var_idxs,
+                                           const bool only_between = false);
   std::vector<std::vector<std::string>>
   tokenise(const bool full_data = false) const;
+  // FNV-1a hash of the id and every observation (in order)
+  uint64_t hash() const;
 };
 
 } // namespace plan_database
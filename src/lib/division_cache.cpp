@@ -0,0 +1,72 @@
+#include "division_cache.h"
+#include <cstdio>
+
+namespace plan_database {
+
+uint64_t DivisionCache::key(const Division &input, const std::string &params) {
+  return fnv1a(params, input.hash());
+}
+
+const Division *DivisionCache::find(const uint64_t key) const {
+  auto it = entries.find(key);
+  return it == entries.end() ? nullptr : &it->second;
+}
+
+void DivisionCache::insert(const uint64_t key, const Division &div) {
+  entries.insert_or_assign(key, div);
+}
+
+int DivisionCache::size() const { return entries.size(); }
+
+void DivisionCache::load(const std::string &path) {
+  if (!std::ifstream(path).good())
+    return;
+
+  // Rows: key, then the full data tokens of one observation
+  for (const std::vector<std::string> &tokens : csv::parse(path)) {
+    if (tokens.size() < 2)
+      throw std::runtime_error("ERROR: Invalid row in cache: " + path);
+
+    const uint64_t key = std::stoull(tokens[0], nullptr, 16);
+    const int id = std::stoi(tokens[1]);
+    Division::Observation ob = Division::Observation::parse_tokens(
+        std::vector<std::string>(tokens.begin() + 1, tokens.end()), true);
+
+    auto it = entries.try_emplace(key, Division(id)).first;
+    it->second.obs.push_back(std::move(ob));
+  }
+}
+
+void DivisionCache::save(const std::string &path) const {
+  std::vector<std::vector<std::string>> rows;
+  char key_str[17], value_str[32];
+  for (const auto &[key, div] : entries) {
+    std::snprintf(key_str, sizeof(key_str), "%016llx",
+                  (unsigned long long)key);
+
+    for (const Division::Observation &ob : div.obs) {
+      std::vector<std::string> tokens = ob.tokenise(true);
+      const int first_var = tokens.size() - ob.vars.size();
+      for (int i = 0; i < ob.vars.size(); i++) {
+        if (ob.vars[i] == EMPTY_NUM)
+          continue;
+        std::snprintf(value_str, sizeof(value_str), "%.17g", ob.vars[i]);
+        tokens[first_var + i] = value_str;
+      }
+
+      tokens.insert(tokens.begin(), std::to_string(div.id));
+      tokens.insert(tokens.begin(), key_str);
+      rows.push_back(std::move(tokens));
+    }
+  }
+
+  std::vector<std::string> header = {"key",  "id",   "code", "industry",
+                                     "sni",  "year", "name"};
+  for (int i = 1; i <= 65; i++) {
+    header.push_back("X" + std::to_string(i));
+  }
+
+  csv::write(path, rows, ',', header);
+}
+
+} // namespace plan_database
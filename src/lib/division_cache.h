@@ -0,0 +1,32 @@
+#ifndef DIVISION_CACHE_H
+#define DIVISION_CACHE_H
+
+#include "division.h"
+#include <cstdint>
+#include <map>
+#include <string>
+
+namespace plan_database {
+
+// On-disk cache of processed divisions, keyed by the hash of the input
+// division (Division::hash()) combined with the processing parameters (see
+// key()). Values are written in full precision.
+class DivisionCache {
+public:
+  static uint64_t key(const Division &input, const std::string &params);
+
+  const Division *find(const uint64_t key) const; // nullptr if not cached
+  void insert(const uint64_t key, const Division &div);
+  int size() const;
+
+  // A missing file is an empty cache
+  void load(const std::string &path);
+  void save(const std::string &path) const;
+
+private:
+  std::map<uint64_t, Division> entries;
+};
+
+} // namespace plan_database
+
+#endif // DIVISION_CACHE_H
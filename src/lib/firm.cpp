@@ -55,31 +55,33 @@ Firm::Firm(const std::vector<Firm> &firms, const MacroData &macrodata,
   obs = std::vector<Observation>();
   is_synthetic = true;
 
-  // Aggregate macro data by year
-  std::map<int, MacroData::Observation> macro_by_year;
-  for (const MacroData::Observation &mac_ob : macrodata.obs) {
+  // Real firm sums per (year x market), joined with the macro totals by year
+  std::vector<Observation> sums = aggregate(firms, macrodata);
+
+  for (int year = macrodata.year_low; year <= macrodata.year_high; year++) {
     if (!years.empty() &&
-        std::find(years.begin(), years.end(), mac_ob.year) == years.end())
+        std::find(years.begin(), years.end(), year) == years.end())
+      continue;
+
+    const MacroData::Observation *mac_ob = macrodata.get_total(year);
+    if (!mac_ob)
       continue;
 
-    auto it = macro_by_year.find(mac_ob.year);
-    if (it == macro_by_year.end()) {
-      macro_by_year[mac_ob.year] = mac_ob;
-    } else {
-      it->second.employees += mac_ob.employees;
-      it->second.sales += mac_ob.sales;
-      it->second.input_cost += mac_ob.input_cost;
-      it->second.wage_sum += mac_ob.wage_sum;
+    Observation real = {year, 0, 0, 0, 0, 0};
+    for (int i = 0; i < N_MKT_PLAN; i++) {
+      const Observation &cell =
+          sums[(year - macrodata.year_low) * N_MKT_PLAN + i];
+      real.employees += cell.employees;
+      real.sales += cell.sales;
+      real.input_cost += cell.input_cost;
+      real.wage_sum += cell.wage_sum;
     }
-  }
 
-  // Subtract all real firms from macro totals for each year
-  for (const auto &[year, mac_ob] : macro_by_year) {
-    double employees = mac_ob.employees - aggregate(firms, year, "employees");
-    double sales = mac_ob.sales - aggregate(firms, year, "sales");
-    double input_cost =
-        mac_ob.input_cost - aggregate(firms, year, "input_cost");
-    double wage_sum = mac_ob.wage_sum - aggregate(firms, year, "wage_sum");
+    // Subtract all real firms from macro totals
+    double employees = mac_ob->employees - real.employees;
+    double sales = mac_ob->sales - real.sales;
+    double input_cost = mac_ob->input_cost - real.input_cost;
+    double wage_sum = mac_ob->wage_sum - real.wage_sum;
     double wage = wage_sum / employees;
 
     if (employees <= 0 || sales <= 0 || input_cost <= 0 || wage_sum <= 0)
@@ -102,29 +104,31 @@ Firm::Firm(const std::vector<Firm> &firms, const MacroData &macrodata,
   obs = std::vector<Observation>();
   is_synthetic = true;
 
-  for (const MacroData::Observation &mac_ob : macrodata.obs) {
+  std::vector<Observation> sums = aggregate(firms, macrodata);
+
+  for (int year = macrodata.year_low; year <= macrodata.year_high; year++) {
     if (!years.empty() &&
-        std::find(years.begin(), years.end(), mac_ob.year) == years.end())
+        std::find(years.begin(), years.end(), year) == years.end())
       continue;
-    if (mac_ob.mkt_id != _mkt_id)
+
+    const MacroData::Observation *mac_ob = macrodata.get(year, _mkt_id);
+    if (!mac_ob)
       continue;
 
-    int year = mac_ob.year;
+    const Observation &real =
+        sums[(year - macrodata.year_low) * N_MKT_PLAN + _mkt_id];
 
-    double employees =
-        mac_ob.employees - aggregate(firms, year, "employees", mkt_id);
-    double sales = mac_ob.sales - aggregate(firms, year, "sales", mkt_id);
-    double input_cost =
-        mac_ob.input_cost - aggregate(firms, year, "input_cost", mkt_id);
-    double wage_sum =
-        mac_ob.wage_sum - aggregate(firms, year, "wage_sum", mkt_id);
+    double employees = mac_ob->employees - real.employees;
+    double sales = mac_ob->sales - real.sales;
+    double input_cost = mac_ob->input_cost - real.input_cost;
+    double wage_sum = mac_ob->wage_sum - real.wage_sum;
     double wage = wage_sum / employees;
 
     if (employees <= 0 || sales <= 0 || input_cost <= 0 || wage_sum <= 0)
       throw std::runtime_error("ERROR: Invalid value in initialisation of "
                                "synthetic residual firm (mkt_id: " +
                                std::to_string(_mkt_id) +
-                               " year: " + std::to_string(mac_ob.year) + ")");
+                               " year: " + std::to_string(year) + ")");
 
     obs.push_back({year, employees, sales, input_cost, wage_sum, wage});
   }
@@ -136,6 +140,33 @@ Firm::Firm(const std::vector<Firm> &firms, const MacroData &macrodata,
         std::to_string(_mkt_id));
 }
 
+std::vector<Firm::Observation>
+Firm::aggregate(const std::vector<Firm> &firms, const MacroData &macrodata) {
+  const int n_years = macrodata.year_high - macrodata.year_low + 1;
+  std::vector<Observation> sums(n_years * N_MKT_PLAN, {0, 0, 0, 0, 0, 0});
+
+  // One pass over all real firm observations
+  for (const Firm &firm : firms) {
+    if (firm.is_synthetic || firm.mkt_id < 0 || firm.mkt_id >= N_MKT_PLAN)
+      continue;
+
+    for (const Observation &ob : firm.obs) {
+      if (ob.year < macrodata.year_low || ob.year > macrodata.year_high)
+        continue;
+
+      Observation &cell =
+          sums[(ob.year - macrodata.year_low) * N_MKT_PLAN + firm.mkt_id];
+      cell.year = ob.year;
+      cell.employees += ob.employees;
+      cell.sales += ob.sales;
+      cell.input_cost += ob.input_cost;
+      cell.wage_sum += ob.wage_sum;
+    }
+  }
+
+  return sums;
+}
+
 double Firm::aggregate(const std::vector<Firm> &firms, const int year,
                        const std::string var_name, const int mkt_id) {
   double ret = 0;
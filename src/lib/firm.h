@@ -45,6 +45,10 @@ public:
   static double aggregate(const std::vector<Firm> &firms, const int year,
                           const std::string var_name,
                           const int mkt_id = NO_MKT);
+  static std::vector<Observation>
+  aggregate(const std::vector<Firm> &firms,
+            const MacroData &macrodata); // Sums per (year x market) cell of
+                                         // the macro table
 
   std::vector<Firm> static to_real_firms(
       const PlanData &plandata,
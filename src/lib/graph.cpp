@@ -9,91 +9,256 @@ Graph::Serie::Serie(std::vector<Point> &_points, const std::string _name,
                     const int _style_id)
     : points(_points), style_id(_style_id), name(_name) {}
 
+Graph::Serie::Serie(const SalterCurve &curve, const std::string _name,
+                    const int _style_id)
+    : style_id(_style_id), name(_name) {
+  points.reserve(curve.size());
+  for (size_t i = 0; i < curve.size(); i++) {
+    points.push_back(Point(curve.weights[i], curve.y[i], curve.marked[i]));
+  }
+}
+
 void Graph::Serie::sort_points() {
-  std::sort(points.begin(), points.end(),
-            [](const Point &a, const Point &b) { return a.y > b.y; });
+  SalterCurve curve = to_salter_curve(true);
+
+  std::vector<Point> sorted_points;
+  sorted_points.reserve(points.size());
+  for (const int idx : curve.index) {
+    sorted_points.push_back(points[idx]);
+  }
+
+  points = std::move(sorted_points);
+}
+
+SalterCurve Graph::Serie::to_salter_curve(const bool sort) const {
+  std::vector<double> weights, heights;
+  std::vector<char> marked;
+  weights.reserve(points.size());
+  heights.reserve(points.size());
+  marked.reserve(points.size());
+  for (const Point &point : points) {
+    weights.push_back(point.x);
+    heights.push_back(point.y);
+    marked.push_back(point.is_marked);
+  }
+
+  return SalterCurve(weights, heights, marked, sort);
 }
 
 QString Graph::Serie::get_serie_name(const int style_idx) const {
   if (name == "")
     return QString::fromStdString("");
   else
-    return QString::fromStdString(line_style_legends[style_idx] + "  " + name +
-                                  "     ");
+    return QString::fromStdString(VectorChart::line_style_legends[style_idx] +
+                                  "  " + name + "     ");
 }
 
-std::vector<QLineSeries *>
-Graph::Serie::create_salter_series_segments(const int style_idx) const {
-  std::vector<QLineSeries *> series_segments;
+std::vector<Graph::Point>
+Graph::Serie::downsample_steps(const int n_px) const {
+  const size_t n = points.size();
+  if (n_px == NA || n <= 4 * (size_t)n_px)
+    return points;
+
+  double total = 0.0;
+  for (const Point &point : points) {
+    total += point.x;
+  }
+  if (total <= 0)
+    return points;
 
-  double x_total =
-      std::accumulate(points.begin(), points.end(), 0.0,
-                      [](double sum, const Point &p) { return sum += p.x; });
+  std::vector<Point> kept;
+  kept.reserve(8 * n_px);
 
-  QLineSeries *current_series = nullptr;
-  bool current_marked_status;
+  // Groups of consecutive steps starting in the same pixel column
   double cum = 0.0;
-  bool first_series = true;
-  double previous_y = 0.0; // Track previous y-value to connect segments
+  size_t begin = 0;
+  while (begin < n) {
+    const int column = (int)(cum / total * n_px);
+    const bool is_marked = points[begin].is_marked;
+
+    size_t end = begin, low = begin, high = begin;
+    double group_cum = cum;
+    while (end < n && points[end].is_marked == is_marked &&
+           (int)(group_cum / total * n_px) == column) {
+      if (points[end].y < points[low].y)
+        low = end;
+      if (points[end].y > points[high].y)
+        high = end;
+      group_cum += points[end].x;
+      end++;
+    }
+
+    for (size_t i = begin; i < end; i++) {
+      if (is_marked || i == begin || i == low || i == high || i == end - 1)
+        kept.push_back(points[i]);
+      else
+        kept.back().x += points[i].x;
+    }
 
-  for (size_t i = 0; i < points.size(); i++) {
-    const Point &point = points[i];
+    cum = group_cum;
+    begin = end;
+  }
 
-    if (i == 0 || point.is_marked != current_marked_status) {
+  return kept;
+}
 
-      // Add connection to the upcoming new segment if previous not marked
-      if (!current_marked_status && i > 0 && previous_y != point.y &&
-          !first_series)
-        current_series->append(cum, point.y);
+std::vector<Graph::Point>
+Graph::Serie::downsample_lttb(const int n_out) const {
+  const int n = (int)points.size();
+  if (n_out == NA || n <= n_out || n_out < 3)
+    return points;
+
+  std::vector<char> keep(n, 0);
+  keep[0] = keep[n - 1] = 1;
+
+  // Largest triangle in each bucket, with the previous kept point and the
+  // mean of the next bucket
+  const double bucket_size = (double)(n - 2) / (n_out - 2);
+  int a = 0;
+  for (int b = 0; b < n_out - 2; b++) {
+    const int begin = 1 + (int)(b * bucket_size);
+    const int end = std::min(1 + (int)((b + 1) * bucket_size), n - 1);
+    const int next_end = std::min(1 + (int)((b + 2) * bucket_size), n);
+
+    double mean_x = 0.0, mean_y = 0.0;
+    for (int i = end; i < next_end; i++) {
+      mean_x += points[i].x;
+      mean_y += points[i].y;
+    }
+    const int n_next = std::max(next_end - end, 1);
+    mean_x /= n_next;
+    mean_y /= n_next;
+
+    double max_area = -1.0;
+    int best = begin;
+    for (int i = begin; i < end; i++) {
+      const Point &p = points[a], &q = points[i];
+      double area = std::abs((p.x - mean_x) * (q.y - p.y) -
+                             (p.x - q.x) * (mean_y - p.y));
+      if (area > max_area) {
+        max_area = area;
+        best = i;
+      }
+    }
 
-      // Initialise new segment
-      current_series = new QLineSeries();
+    keep[best] = 1;
+    a = best;
+  }
 
-      // Name
-      if (first_series) {
-        current_series->setName(get_serie_name(style_idx));
-        first_series = false;
+  // Marked points and extrema
+  auto [min_it, max_it] = std::minmax_element(
+      points.begin(), points.end(),
+      [](const Point &a, const Point &b) { return a.y < b.y; });
+  keep[min_it - points.begin()] = keep[max_it - points.begin()] = 1;
+
+  std::vector<Point> kept;
+  kept.reserve(n_out + 2);
+  for (int i = 0; i < n; i++) {
+    if (keep[i] || points[i].is_marked)
+      kept.push_back(points[i]);
+  }
+
+  return kept;
+}
+
+std::pair<QPainterPath, QPainterPath>
+Graph::Serie::create_salter_paths(const int n_px) const {
+  const std::vector<Point> steps = downsample_steps(n_px);
+
+  QPainterPath plain, marked;
+  plain.reserve(2 * (int)steps.size() + 1);
+
+  double cum = 0.0, total = 0.0;
+  for (const Point &step : steps) {
+    total += step.x;
+  }
+
+  for (size_t i = 0; i < steps.size(); i++) {
+    const Point &point = steps[i];
+    const double x_low = cum;
+    const double x_high = cum + 100 * point.x / total;
+    cum = x_high;
+
+    if (i == 0 || point.is_marked != steps[i - 1].is_marked) {
+      const double previous_y = i > 0 ? steps[i - 1].y : point.y;
+
+      // Connections between spans are drawn unmarked
+      if (point.is_marked) {
+        if (i > 0)
+          plain.lineTo(x_low, point.y);
+        marked.moveTo(x_low, point.y);
+
+        // Vertical line at the beginning of marked spans if beam_mark
+        if (beam_mark) {
+          marked.lineTo(x_low, 0);
+          marked.lineTo(x_low, point.y);
+        }
       } else {
-        current_series->setName("");
+        plain.moveTo(x_low, previous_y);
       }
+    }
 
-      // Styling
-      QPen pen;
-      if (point.is_marked)
-        pen = QPen(QColor(220, 50, 50), 2, line_styles[style_idx]);
-      else
-        pen = QPen(line_color, 2, line_styles[style_idx]);
-      pen.setJoinStyle(Qt::MiterJoin);
-      current_series->setPen(pen);
-
-      // Add connection to previous segment if previous was marked
-      if (current_marked_status && i > 0 && previous_y != point.y &&
-          !first_series)
-        current_series->append(cum, previous_y);
-
-      // Add vertical line at the beginning of marked section if beam_mark
-      // options is enabled
-      if (beam_mark && point.is_marked) {
-        current_series->append(cum, point.y);
-        current_series->append(cum, 0);
-        current_series->append(cum, point.y);
-      }
+    QPainterPath &path = point.is_marked ? marked : plain;
+    path.lineTo(x_low, point.y);
+    path.lineTo(x_high, point.y);
+  }
 
-      // Move segment to list and update marked status
-      series_segments.push_back(current_series);
-      current_marked_status = point.is_marked;
-    }
+  return std::make_pair(plain, marked);
+}
+
+Graph::SalterItem::SalterItem(QChart *_chart,
+                              const std::pair<double, double> _x_range,
+                              const std::pair<double, double> _y_range)
+    : QGraphicsItem(_chart), chart(_chart), x_range(_x_range),
+      y_range(_y_range) {
+  setZValue(10); // Above the chart background and axes
+}
+
+void Graph::SalterItem::add_serie(const Serie &serie, const int style_idx) {
+  series.push_back(std::make_pair(serie, style_idx));
+  set_resolution(n_px);
+}
+
+void Graph::SalterItem::set_resolution(const int _n_px) {
+  n_px = _n_px;
+  paths.clear();
+  for (const auto &[serie, style_idx] : series) {
+    auto [plain, marked] = serie.create_salter_paths(n_px);
 
-    // Add point to current series
-    double share = 100 * point.x / x_total;
-    current_series->append(cum, point.y);
-    cum += share;
-    current_series->append(cum, point.y);
+    QPen plain_pen = QPen(line_color, 2, line_styles[style_idx]);
+    QPen marked_pen = QPen(QColor(220, 50, 50), 2, line_styles[style_idx]);
+    plain_pen.setJoinStyle(Qt::MiterJoin);
+    marked_pen.setJoinStyle(Qt::MiterJoin);
 
-    previous_y = point.y; // Remember this y-value for next iteration
+    paths.push_back(std::make_pair(plain, plain_pen));
+    if (!marked.isEmpty())
+      paths.push_back(std::make_pair(marked, marked_pen));
   }
+  update();
+}
 
-  return series_segments;
+QRectF Graph::SalterItem::boundingRect() const {
+  return chart->boundingRect();
+}
+
+void Graph::SalterItem::paint(QPainter *painter,
+                              const QStyleOptionGraphicsItem *option,
+                              QWidget *widget) {
+  // Chart values to plot area pixels
+  const QRectF plot = chart->plotArea();
+  const double sx = plot.width() / (x_range.second - x_range.first);
+  const double sy = -plot.height() / (y_range.second - y_range.first);
+  const QTransform transform(sx, 0, 0, sy, plot.left() - sx * x_range.first,
+                             plot.bottom() - sy * y_range.first);
+
+  painter->save();
+  painter->setClipRect(plot);
+  painter->setBrush(Qt::NoBrush);
+  for (const auto &[path, pen] : paths) {
+    painter->setPen(pen);
+    painter->drawPath(transform.map(path));
+  }
+  painter->restore();
 }
 
 Graph::Graph(const std::string &_title, const std::string &_x_label,
@@ -107,7 +272,7 @@ Graph::Graph(const std::string &_title, const std::string &_x_label,
 QChart *Graph::create_chart(const std::pair<double, double> x_range,
                             const std::pair<double, double> y_range,
                             const std::pair<int, int> n_ticks) {
-  QChart *chart = new QChart();
+  chart.reset(new QChart()); // Releases the previous chart
   chart->setTitle(title);
 
   // Append series to chart
@@ -253,30 +418,14 @@ QChart *Graph::create_chart(const std::pair<double, double> x_range,
   chart->setMargins(QMargins(0, 0, 0, 0)); // Extra bottom margin for legend
   chart->setBackgroundRoundness(0);
 
-  return chart;
+  return chart.get();
 }
 
 QChart *Graph::create_salter_chart(const std::pair<double, double> y_range,
                                    const int n_y_ticks) {
-  QChart *chart = new QChart();
+  chart.reset(new QChart()); // Releases the previous chart
   chart->setTitle(title);
 
-  // Append series to chart
-  int style_count = 0;
-  for (const Serie &serie : series) {
-    int style_idx = serie.style_id == NA ? style_count++ : serie.style_id;
-    if (style_idx >= N_STYLES)
-      throw std::runtime_error("ERROR: style_idx > N_STYLES. Too many salter "
-                               "series without set styles.");
-
-    // Add series
-    std::vector<QLineSeries *> series_segments =
-        serie.create_salter_series_segments(style_idx);
-    for (QLineSeries *series_segment : series_segments) {
-      chart->addSeries(series_segment);
-    }
-  }
-
   // X-axis
   QValueAxis *x_axis = new QValueAxis();
   x_axis->setTitleText(x_label);
@@ -314,6 +463,26 @@ QChart *Graph::create_salter_chart(const std::pair<double, double> y_range,
 
   y_axis->setRange(y_min, y_max);
 
+  // Step curves are drawn by one item, each serie only adds an empty line
+  // series for its legend entry
+  SalterItem *salter_item =
+      new SalterItem(chart.get(), {0, 100}, {y_min, y_max});
+
+  int style_count = 0;
+  for (const Serie &serie : series) {
+    int style_idx = serie.style_id == NA ? style_count++ : serie.style_id;
+    if (style_idx >= N_STYLES)
+      throw std::runtime_error("ERROR: style_idx > N_STYLES. Too many salter "
+                               "series without set styles.");
+
+    salter_item->add_serie(serie, style_idx);
+
+    QLineSeries *legend_series = new QLineSeries();
+    legend_series->setName(serie.get_serie_name(style_idx));
+    legend_series->setPen(QPen(line_color, 2, line_styles[style_idx]));
+    chart->addSeries(legend_series);
+  }
+
   // Font configuration
   QFont title_font("Courier New", 28, QFont::Bold);
   QFont axis_font("Courier New", 18, QFont::Medium);
@@ -376,28 +545,120 @@ QChart *Graph::create_salter_chart(const std::pair<double, double> y_range,
   chart->setMargins(QMargins(0, 0, 0, 0)); // Extra bottom margin for legend
   chart->setBackgroundRoundness(0);
 
-  return chart;
+  return chart.get();
+}
+
+QGraphicsScene &Graph::get_scene() {
+  // One scene for every export, deleted with the application
+  static QGraphicsScene *scene = nullptr;
+  if (scene == nullptr) {
+    scene = new QGraphicsScene(qApp);
+    scene->setItemIndexMethod(QGraphicsScene::NoIndex); // Charts are resized
+    scene->setBackgroundBrush(QBrush(Qt::white));
+  }
+
+  return *scene;
 }
 
 void Graph::export_chart(const std::string &path, QChart *chart,
-                         const int width, const int height) {
-  QChartView *chart_view = new QChartView(chart);
-  // chart_view->setRenderHint(QPainter::Antialiasing);
-  chart_view->setFrameStyle(QFrame::NoFrame);
-  chart_view->setContentsMargins(0, 0, 0, 0);
-  chart_view->setBackgroundBrush(QBrush(Qt::white));
-
-  QMainWindow window;
-  window.setCentralWidget(chart_view);
-  window.resize(width, height);
-  window.setStyleSheet("background-color: white; border: none;");
-  window.show();
-
-  // Write chart view to PNG
-  QPixmap pixmap = chart_view->grab();
-  QString file_name = QString::fromStdString(path + ".PNG");
-  pixmap.save(file_name, "PNG" /* JPEG */, 100 /* max quality */);
-  std::cout << "Saved PNG: " << file_name.toStdString() << std::endl;
+                         const int width, const int height,
+                         const ExportFormat format) {
+  QGraphicsScene &scene = get_scene();
+  scene.addItem(chart);
+  chart->setGeometry(QRectF(0, 0, width, height));
+  scene.setSceneRect(0, 0, width, height);
+
+  // Downsample to the export width, keeping the full series to restore
+  std::vector<std::pair<QLineSeries *, QList<QPointF>>> full_series;
+  for (QAbstractSeries *abstract_series : chart->series()) {
+    QLineSeries *line_series = qobject_cast<QLineSeries *>(abstract_series);
+    if (line_series == nullptr || line_series->count() <= width)
+      continue;
+
+    const QList<QPointF> full_points = line_series->points();
+    std::vector<Point> points;
+    points.reserve(full_points.size());
+    for (const QPointF &point : full_points) {
+      points.push_back(Point(point.x(), point.y()));
+    }
+
+    QList<QPointF> kept_points;
+    for (const Point &point : Serie(points).downsample_lttb(width)) {
+      kept_points.append(QPointF(point.x, point.y));
+    }
+    line_series->replace(kept_points);
+    full_series.push_back(std::make_pair(line_series, full_points));
+  }
+  std::vector<SalterItem *> salter_items;
+  for (QGraphicsItem *item : chart->childItems()) {
+    if (SalterItem *salter_item = dynamic_cast<SalterItem *>(item)) {
+      salter_item->set_resolution(width);
+      salter_items.push_back(salter_item);
+    }
+  }
+
+  QString file_name;
+  switch (format) {
+  case PNG: {
+    file_name = QString::fromStdString(path + ".PNG");
+    QImage image(width, height, QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::white);
+
+    QPainter painter(&image);
+    scene.render(&painter);
+    painter.end();
+
+    if (!image.save(file_name, "PNG" /* JPEG */, 100 /* max quality */)) {
+      throw std::runtime_error("ERROR: Could not write chart to " +
+                               file_name.toStdString());
+    }
+    break;
+  }
+  case SVG: {
+    file_name = QString::fromStdString(path + ".SVG");
+    QSvgGenerator generator;
+    generator.setFileName(file_name);
+    generator.setSize(QSize(width, height));
+    generator.setViewBox(QRect(0, 0, width, height));
+
+    QPainter painter(&generator);
+    scene.render(&painter);
+    painter.end();
+    break;
+  }
+  case PDF: {
+    // One page of exactly the chart's size (1 px = 1 pt)
+    file_name = QString::fromStdString(path + ".PDF");
+    QPrinter printer(QPrinter::HighResolution);
+    printer.setOutputFormat(QPrinter::PdfFormat);
+    printer.setOutputFileName(file_name);
+    printer.setPageSize(QPageSize(QSizeF(width, height), QPageSize::Point));
+    printer.setPageMargins(QMarginsF(0, 0, 0, 0));
+    printer.setFullPage(true);
+
+    QPainter painter(&printer);
+    scene.render(&painter);
+    painter.end();
+    break;
+  }
+  }
+
+  for (auto &[line_series, full_points] : full_series) {
+    line_series->replace(full_points);
+  }
+  for (SalterItem *salter_item : salter_items) {
+    salter_item->set_resolution(NA);
+  }
+
+  scene.removeItem(chart); // Ownership stays with the caller
+  std::cout << "Saved chart: " << file_name.toStdString() << std::endl;
+}
+
+void Graph::use_offscreen_platform() {
+  // Keep an explicitly chosen platform (e.g. to debug on screen)
+  if (!qEnvironmentVariableIsSet("QT_QPA_PLATFORM")) {
+    qputenv("QT_QPA_PLATFORM", "offscreen");
+  }
 }
 
 } // namespace plan_database
@@ -2,35 +2,45 @@
 #define GRAPH_H
 
 #include "firm.h"
+#include "salter.h"
 #include "utility.h"
+#include "vector_chart.h"
 #include <QtCharts/QChart>
-#include <QtCharts/QChartView>
 #include <QtCharts/QLegend>
 #include <QtCharts/QLegendMarker>
 #include <QtCharts/QLineSeries>
 #include <QtCharts/QValueAxis>
+#include <QtCore/QList>
+#include <QtCore/QMargins>
+#include <QtCore/QPointF>
 #include <QtCore/QString>
 #include <QtGui/QBrush>
 #include <QtGui/QFont>
+#include <QtGui/QImage>
+#include <QtGui/QPageSize>
 #include <QtGui/QPainter>
+#include <QtGui/QPainterPath>
 #include <QtGui/QPen>
-#include <QtGui/QPixmap>
 #include <QtPrintSupport/QPrinter>
+#include <QtSvg/QSvgGenerator>
 #include <QtWidgets/QApplication>
-#include <QtWidgets/QMainWindow>
+#include <QtWidgets/QGraphicsItem>
+#include <QtWidgets/QGraphicsScene>
+#include <QtWidgets/QStyleOptionGraphicsItem>
 #include <cstddef>
 #include <iostream>
 #include <map>
+#include <memory>
 #include <stdexcept>
 #include <string>
 #include <vector>
 
-#define N_STYLES 5
-
 namespace plan_database {
 
 class Graph {
 public:
+  enum ExportFormat { PNG, SVG, PDF };
+
   struct Point {
     double x, y;
     bool is_marked = false;
@@ -47,17 +57,56 @@ public:
 
     Serie(std::vector<Point> &_points, const std::string _name = "",
           const int _style_id = NA);
+    Serie(const SalterCurve &curve, const std::string _name = "",
+          const int _style_id = NA); // Points in step order (x: weight)
 
     void sort_points();
+    SalterCurve to_salter_curve(const bool sort = false) const;
     QString get_serie_name(const int style_idx) const;
 
-    std::vector<QLineSeries *>
-    create_salter_series_segments(const int style_idx) const;
+    // Downsampling before rendering. Marked points and extrema are kept.
+    //
+    // Steps within the same pixel column (of n_px) and with the same marked
+    // status are reduced to the first, lowest, highest and last step; dropped
+    // steps add their width to the previous kept step.
+    std::vector<Point> downsample_steps(const int n_px) const;
+    // Largest-triangle-three-buckets on points sorted by x
+    std::vector<Point> downsample_lttb(const int n_out) const;
+
+    // Step curve in chart values: unmarked and marked spans
+    std::pair<QPainterPath, QPainterPath>
+    create_salter_paths(const int n_px = NA) const;
+  };
+
+  // Draws whole salter step curves as one QPainterPath per serie and marked
+  // status, mapped onto the plot area of the parent chart when painted.
+  class SalterItem : public QGraphicsItem {
+  public:
+    SalterItem(QChart *_chart, const std::pair<double, double> _x_range,
+               const std::pair<double, double> _y_range);
+
+    void add_serie(const Serie &serie, const int style_idx);
+    // Rebuilds the paths downsampled to n_px pixel columns (NA: all steps)
+    void set_resolution(const int n_px);
+
+    QRectF boundingRect() const override;
+    void paint(QPainter *painter, const QStyleOptionGraphicsItem *option,
+               QWidget *widget = nullptr) override;
+
+  private:
+    QChart *chart;
+    std::pair<double, double> x_range, y_range;
+    std::vector<std::pair<Serie, int>> series; // serie and style
+    std::vector<std::pair<QPainterPath, QPen>> paths;
+    int n_px = NA;
   };
 
   std::vector<Serie> series;
   QString title, x_label, y_label;
 
+  // The last created chart, owned by the graph
+  std::unique_ptr<QChart> chart;
+
   // Configuration
   //
   //
@@ -70,13 +119,6 @@ public:
       Qt::DotLine,        // Dotted line
 
   };
-  static inline std::string line_style_legends[N_STYLES] = {
-      "─────",   // SolidLine
-      "─ ─ ─",   // DashLine
-      "─·─·─",   // DashDotLine
-      "─··─··─", // DashDotDotLine
-      "· · ·",   // DotLine
-  };
 
   //
   //
@@ -92,8 +134,18 @@ public:
                                                                          NA},
                               const int n_y_ticks = NA);
 
+  // Renders the chart through a shared QGraphicsScene straight into an image,
+  // SVG or PDF file, without creating a window. Series are downsampled to the
+  // export width while rendering only. The chart is removed from the scene
+  // afterwards and stays owned by the caller.
   static void export_chart(const std::string &path, QChart *chart,
-                           const int width = 2000, const int length = 2000);
+                           const int width = 2000, const int length = 2000,
+                           const ExportFormat format = PNG);
+
+  static QGraphicsScene &get_scene();
+
+  // Call before constructing QApplication to run without a display server
+  static void use_offscreen_platform();
 }; // namespace plan_database
 
 } // namespace plan_database
@@ -0,0 +1,246 @@
+#include "index_series.h"
+
+namespace plan_database {
+
+bool IndexSeries::is_included(const Population population,
+                              const Sample sample) {
+  // The synthetic residual completes the macro total of each year only
+  // together with every real firm of that year
+  return !(population == MACRO && sample == BALANCED);
+}
+
+double IndexSeries::get_level(const DerivedVariables::Formula &formula,
+                              const Sums &sums) {
+  if (sums.n_firms == 0)
+    return NA;
+  if (formula.denominator == NO_DENOMINATOR)
+    return formula.scale * sums.num;
+  if (sums.den == 0)
+    return NA;
+
+  return formula.scale * sums.num / sums.den;
+}
+
+IndexSeries::IndexSeries(const FirmPanel &panel,
+                         const DerivedVariables &derived, const int low,
+                         const int _base_year)
+    : year_low(std::max(low, panel.year_low)), year_high(panel.year_high),
+      base_year(_base_year) {
+  if (base_year < year_low || base_year > year_high)
+    throw std::runtime_error("ERROR: Index base year " +
+                             std::to_string(base_year) +
+                             " outside of the firm panel");
+
+  const int n_years = year_high - year_low + 1;
+  const std::vector<DerivedVariables::Formula> &formulas = derived.formulas;
+  const int n_formulas = formulas.size();
+
+  // Non-NA values of one formula in one row
+  auto get_values = [&panel](const int row,
+                             const DerivedVariables::Formula &formula,
+                             double &num, double &den) {
+    num = 0;
+    den = 0;
+    bool is_na = false;
+    for (const auto &[column, weight] : formula.terms) {
+      const double value = panel.columns[column][row];
+      is_na |= value == NA;
+      num += weight * value;
+    }
+    if (formula.denominator != NO_DENOMINATOR) {
+      den = panel.columns[formula.denominator][row];
+      is_na |= den == NA;
+    }
+    return !is_na;
+  };
+
+  // Years in which each real firm has a value of each formula
+  std::unordered_map<int, std::vector<char>> presence; // f * n_years + year
+  for (int year = year_low; year <= year_high; year++) {
+    auto [begin, end] = panel.get_rows(year);
+    for (int row = begin; row < end; row++) {
+      if (panel.is_synthetic[row])
+        continue;
+
+      std::vector<char> &present = presence[panel.firm_ids[row]];
+      present.resize(n_formulas * n_years, false);
+      for (int f = 0; f < n_formulas; f++) {
+        double num, den;
+        if (get_values(row, formulas[f], num, den))
+          present[f * n_years + year - year_low] = true;
+      }
+    }
+  }
+  auto is_present = [&](const int firm_id, const int f, const int year) {
+    return year >= year_low && year <= year_high &&
+           presence.at(firm_id)[f * n_years + year - year_low];
+  };
+  auto is_balanced = [&](const int firm_id, const int f) {
+    const std::vector<char> &present = presence.at(firm_id);
+    return std::find(present.begin() + f * n_years,
+                     present.begin() + (f + 1) * n_years,
+                     false) == present.begin() + (f + 1) * n_years;
+  };
+
+  // Series layout, and the sums of each series, year and subset
+  int combo_idxs[N_POPULATIONS][N_SAMPLES];
+  int n_combos = 0;
+  for (int p = 0; p < N_POPULATIONS; p++) {
+    for (int s = 0; s < N_SAMPLES; s++) {
+      combo_idxs[p][s] =
+          is_included((Population)p, (Sample)s) ? n_combos++ : NA;
+    }
+  }
+
+  const int n_series = n_formulas * n_combos;
+  std::vector<Sums> sums(n_series * n_years * N_SUBSETS);
+  auto get_sums = [&](const int series_idx, const int year,
+                      const Subset subset) -> Sums & {
+    return sums[(series_idx * n_years + year - year_low) * N_SUBSETS + subset];
+  };
+
+  // One pass over the rows, all formulas and series at once
+  for (int year = year_low; year <= year_high; year++) {
+    auto [begin, end] = panel.get_rows(year);
+    for (int row = begin; row < end; row++) {
+      const bool is_synthetic = panel.is_synthetic[row];
+      const int firm_id = panel.firm_ids[row];
+
+      for (int f = 0; f < n_formulas; f++) {
+        double num, den;
+        if (!get_values(row, formulas[f], num, den))
+          continue;
+
+        // Link subsets of the survey: the firm has a value in the adjacent
+        // year too
+        const bool with_prev =
+            !is_synthetic && is_present(firm_id, f, year - 1);
+        const bool with_next =
+            !is_synthetic && is_present(firm_id, f, year + 1);
+        const bool balanced = !is_synthetic && is_balanced(firm_id, f);
+
+        for (int p = 0; p < N_POPULATIONS; p++) {
+          if (p == SURVEY && is_synthetic)
+            continue;
+
+          for (int s = 0; s < N_SAMPLES; s++) {
+            if (combo_idxs[p][s] == NA || (s == BALANCED && !balanced))
+              continue;
+
+            const int series_idx = f * n_combos + combo_idxs[p][s];
+            for (const Subset subset : {ALL, WITH_PREV, WITH_NEXT}) {
+              if ((subset == WITH_PREV && !with_prev) ||
+                  (subset == WITH_NEXT && !with_next))
+                continue;
+
+              Sums &cell = get_sums(series_idx, year, subset);
+              cell.num += num;
+              cell.den += den;
+              cell.n_firms++;
+            }
+          }
+        }
+      }
+    }
+  }
+
+  // Levels and indices
+  for (int f = 0; f < n_formulas; f++) {
+    const DerivedVariables::Formula &formula = formulas[f];
+
+    for (int p = 0; p < N_POPULATIONS; p++) {
+      for (int s = 0; s < N_SAMPLES; s++) {
+        if (combo_idxs[p][s] == NA)
+          continue;
+
+        const int series_idx = f * n_combos + combo_idxs[p][s];
+        Series serie;
+        serie.metric = formula.name;
+        serie.population = (Population)p;
+        serie.sample = (Sample)s;
+        serie.level.resize(n_years);
+        serie.n_firms.resize(n_years);
+        for (int year = year_low; year <= year_high; year++) {
+          const Sums &all = get_sums(series_idx, year, ALL);
+          serie.level[year - year_low] = get_level(formula, all);
+          serie.n_firms[year - year_low] = all.n_firms;
+        }
+
+        // Fixed base
+        const double base = serie.level[base_year - year_low];
+        serie.fixed_base.assign(n_years, NA);
+        for (int i = 0; i < n_years; i++) {
+          if (serie.level[i] != NA && base != NA && base != 0)
+            serie.fixed_base[i] = 100 * serie.level[i] / base;
+        }
+
+        // Chain links: level of the firms in both year - 1 and year, in year
+        // relative to year - 1. The residual firm is the macro total less
+        // every real firm of its year, so macro links compare the totals.
+        const Subset current_subset = p == MACRO ? ALL : WITH_PREV;
+        const Subset previous_subset = p == MACRO ? ALL : WITH_NEXT;
+        std::vector<double> links(n_years, NA);
+        for (int year = year_low + 1; year <= year_high; year++) {
+          const double current =
+              get_level(formula, get_sums(series_idx, year, current_subset));
+          const double previous = get_level(
+              formula, get_sums(series_idx, year - 1, previous_subset));
+          if (current != NA && previous != NA && previous != 0)
+            links[year - year_low] = current / previous;
+        }
+
+        serie.chain_linked.assign(n_years, NA);
+        const int base_idx = base_year - year_low;
+        if (base != NA)
+          serie.chain_linked[base_idx] = 100;
+        for (int i = base_idx + 1; i < n_years; i++) {
+          if (serie.chain_linked[i - 1] != NA && links[i] != NA)
+            serie.chain_linked[i] = serie.chain_linked[i - 1] * links[i];
+        }
+        for (int i = base_idx - 1; i >= 0; i--) {
+          if (serie.chain_linked[i + 1] != NA && links[i + 1] != NA &&
+              links[i + 1] != 0)
+            serie.chain_linked[i] = serie.chain_linked[i + 1] / links[i + 1];
+        }
+
+        series.push_back(serie);
+      }
+    }
+  }
+}
+
+const IndexSeries::Series &IndexSeries::get(const std::string &metric,
+                                            const Population population,
+                                            const Sample sample) const {
+  for (const Series &serie : series) {
+    if (serie.metric == metric && serie.population == population &&
+        serie.sample == sample)
+      return serie;
+  }
+
+  throw std::runtime_error("ERROR: No index series " + metric + " (" +
+                           population_names[population] + ", " +
+                           sample_names[sample] + ")");
+}
+
+void IndexSeries::write_csv(const std::string &path) const {
+  auto num = [](const double d) { return d == NA ? EMPTY : csv::dtostr(d); };
+
+  std::vector<std::vector<std::string>> rows;
+  for (const Series &serie : series) {
+    for (int year = year_low; year <= year_high; year++) {
+      const int i = year - year_low;
+      rows.push_back({serie.metric, population_names[serie.population],
+                      sample_names[serie.sample], std::to_string(year),
+                      num(serie.level[i]), num(serie.fixed_base[i]),
+                      num(serie.chain_linked[i]),
+                      std::to_string(serie.n_firms[i])});
+    }
+  }
+
+  csv::write(path, rows, ',',
+             {"metric", "population", "sample", "year", "level", "fixed_base",
+              "chain_linked", "n_firms"});
+}
+
+} // namespace plan_database
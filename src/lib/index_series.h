@@ -0,0 +1,77 @@
+#ifndef INDEX_SERIES_H
+#define INDEX_SERIES_H
+
+#include "csv.h"
+#include "derived.h"
+#include "panel.h"
+#include "utility.h"
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace plan_database {
+
+// Yearly aggregates of every derived variable over a firm panel as fixed-base
+// and chain-linked indices, from one pass over the year-major rows. The level
+// of a year is the formula applied to sums over firms:
+//   scale * sum(weight * column) / sum(denominator column)
+// A survey chain link compares only the firms with a value in both adjacent
+// years, so the chain-linked index of an unbalanced panel is free of entry and
+// exit. The synthetic residual makes every macro year the full total, so macro
+// links compare the totals and equal the fixed-base index.
+class IndexSeries {
+public:
+  enum Population {
+    SURVEY, // real (planning survey) firms
+    MACRO,  // real and synthetic residual firms, i.e. Swedish manufacturing
+    N_POPULATIONS
+  };
+  enum Sample {
+    UNBALANCED, // every firm of each year
+    BALANCED,   // firms present in every year of the range (survey only)
+    N_SAMPLES
+  };
+  static inline const std::string population_names[N_POPULATIONS] = {
+      "survey", "macro"};
+  static inline const std::string sample_names[N_SAMPLES] = {"unbalanced",
+                                                             "balanced"};
+
+  struct Series {
+    std::string metric;
+    Population population = SURVEY;
+    Sample sample = UNBALANCED;
+    std::vector<double> level, fixed_base, chain_linked; // NA if undefined
+    std::vector<int> n_firms;
+  };
+
+  int year_low = 0, year_high = -1, base_year = 0;
+  std::vector<Series> series; // metric-major, then population, then sample
+
+  IndexSeries(const FirmPanel &panel, const DerivedVariables &derived,
+              const int low, const int _base_year);
+
+  const Series &get(const std::string &metric, const Population population,
+                    const Sample sample = UNBALANCED) const;
+  void write_csv(const std::string &path) const;
+
+private:
+  // Numerator and denominator sums of one year
+  struct Sums {
+    double num = 0, den = 0;
+    int n_firms = 0;
+  };
+  enum Subset {
+    ALL,       // every row of the year
+    WITH_PREV, // rows whose firm is also in the previous year
+    WITH_NEXT, // rows whose firm is also in the next year
+    N_SUBSETS
+  };
+
+  static bool is_included(const Population population, const Sample sample);
+  static double get_level(const DerivedVariables::Formula &formula,
+                          const Sums &sums);
+};
+
+} // namespace plan_database
+
+#endif // INDEX_SERIES_H
@@ -0,0 +1,178 @@
+#include "interpolation.h"
+
+namespace plan_database {
+
+namespace interpolation {
+
+void approx(const std::vector<int> &years, std::vector<double> &values) {
+  const int n = (int)values.size();
+
+  int first = -1, last = -1, n_known = 0;
+  for (int i = 0; i < n; i++) {
+    if (values[i] != EMPTY_NUM) {
+      if (first == -1)
+        first = i;
+      last = i;
+      n_known++;
+    }
+  }
+  if (n_known < 2)
+    return;
+
+  // Constant beyond the outermost known values
+  for (int i = 0; i < first; i++) {
+    values[i] = values[first];
+  }
+  for (int i = last + 1; i < n; i++) {
+    values[i] = values[last];
+  }
+
+  // Linear within each gap between two known values
+  int left = first;
+  for (int i = first + 1; i <= last; i++) {
+    if (values[i] == EMPTY_NUM)
+      continue;
+
+    if (i - left > 1) {
+      const double slope =
+          (values[i] - values[left]) / (years[i] - years[left]);
+      for (int j = left + 1; j < i; j++) {
+        values[j] = values[left] + slope * (years[j] - years[left]);
+      }
+    }
+    left = i;
+  }
+}
+
+// Fritsch-Carlson tangents at the known points (xs, ys)
+static std::vector<double>
+get_monotone_tangents(const std::vector<double> &xs,
+                      const std::vector<double> &ys) {
+  const int n = (int)xs.size();
+  std::vector<double> deltas(n - 1), tangents(n);
+  for (int m = 0; m < n - 1; m++) {
+    deltas[m] = (ys[m + 1] - ys[m]) / (xs[m + 1] - xs[m]);
+  }
+
+  tangents[0] = deltas[0];
+  tangents[n - 1] = deltas[n - 2];
+  for (int m = 1; m < n - 1; m++) {
+    tangents[m] = deltas[m - 1] * deltas[m] <= 0
+                      ? 0.0
+                      : (deltas[m - 1] + deltas[m]) / 2;
+  }
+
+  // Limit tangents to keep every interval monotone
+  for (int m = 0; m < n - 1; m++) {
+    if (deltas[m] == 0) {
+      tangents[m] = tangents[m + 1] = 0.0;
+      continue;
+    }
+
+    const double a = tangents[m] / deltas[m], b = tangents[m + 1] / deltas[m];
+    const double r = a * a + b * b;
+    if (r > 9) {
+      const double tau = 3 / std::sqrt(r);
+      tangents[m] = tau * a * deltas[m];
+      tangents[m + 1] = tau * b * deltas[m];
+    }
+  }
+
+  return tangents;
+}
+
+void fill(const std::vector<int> &years, std::vector<double> &values,
+          const Method method) {
+  if (method == LINEAR) {
+    approx(years, values);
+    return;
+  }
+
+  // Known points
+  std::vector<int> known;
+  for (int i = 0; i < (int)values.size(); i++) {
+    if (values[i] != EMPTY_NUM)
+      known.push_back(i);
+  }
+  if (known.size() < (method == LOCF ? 1 : 2))
+    return;
+
+  // Constant beyond the outermost known values
+  for (int i = 0; i < known.front(); i++) {
+    values[i] = values[known.front()];
+  }
+  for (int i = known.back() + 1; i < (int)values.size(); i++) {
+    values[i] = values[known.back()];
+  }
+
+  std::vector<double> tangents;
+  if (method == SPLINE) {
+    std::vector<double> xs, ys;
+    for (const int i : known) {
+      xs.push_back(years[i]);
+      ys.push_back(values[i]);
+    }
+    tangents = get_monotone_tangents(xs, ys);
+  }
+
+  // Gap runs between consecutive known values
+  for (int m = 0; m + 1 < (int)known.size(); m++) {
+    const int left = known[m], right = known[m + 1];
+    if (right - left < 2)
+      continue;
+
+    const double y0 = values[left], y1 = values[right];
+    const double h = years[right] - years[left];
+    for (int i = left + 1; i < right; i++) {
+      const double t = (years[i] - years[left]) / h;
+
+      if (method == LOCF) {
+        values[i] = y0;
+      } else if (method == GROWTH && y0 > 0 && y1 > 0) {
+        values[i] = y0 * std::pow(y1 / y0, t);
+      } else if (method == SPLINE) {
+        // Cubic Hermite basis
+        const double t2 = t * t, t3 = t2 * t;
+        values[i] = (2 * t3 - 3 * t2 + 1) * y0 +
+                    (t3 - 2 * t2 + t) * h * tangents[m] +
+                    (-2 * t3 + 3 * t2) * y1 + (t3 - t2) * h * tangents[m + 1];
+      } else {
+        values[i] = y0 + t * (y1 - y0);
+      }
+    }
+  }
+}
+
+void interpolate(Division &div, const std::vector<int> &var_idxs,
+                 const Method method) {
+  const int n = (int)div.obs.size();
+  std::vector<int> years(n);
+  std::vector<double> values(n);
+  for (int i = 0; i < n; i++) {
+    years[i] = div.obs[i].year;
+  }
+
+  // One variable column of the division at a time
+  for (const int var : var_idxs) {
+    for (int i = 0; i < n; i++) {
+      values[i] = div.obs[i].vars[var];
+    }
+
+    fill(years, values, method);
+
+    for (int i = 0; i < n; i++) {
+      div.obs[i].vars[var] = values[i];
+    }
+  }
+}
+
+void interpolate(PlanData &plandata, const std::vector<int> &var_idxs,
+                 const Method method) {
+  for (Division &div : plandata.divs) {
+    interpolate(div, var_idxs, method);
+  }
+}
+
+} // namespace interpolation
+
+} // namespace plan_database
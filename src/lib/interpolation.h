@@ -0,0 +1,47 @@
+#ifndef INTERPOLATION_H
+#define INTERPOLATION_H
+
+#include "plandata.h"
+#include <cmath>
+#include <string>
+#include <vector>
+
+namespace plan_database {
+
+namespace interpolation {
+
+enum Method {
+  LINEAR, // Linear between known values
+  SPLINE, // Monotone cubic (Fritsch-Carlson), no overshoot between values
+  LOCF,   // Last observation carried forward (next one backward at start)
+  GROWTH, // Constant growth rate (log-linear), linear if not positive
+  N_METHODS
+};
+const std::string method_names[N_METHODS] = {"linear", "spline", "locf",
+                                              "growth"};
+
+// Fills the missing values (EMPTY_NUM) of one series like R's
+// approx(rule = 2): linear between the known values, constant beyond the
+// outermost ones. Series with fewer than two known values are left as is.
+// years must be sorted ascending.
+void approx(const std::vector<int> &years, std::vector<double> &values);
+
+// Fills the gaps (runs of EMPTY_NUM between known values) of one series with
+// the given method, and beyond the outermost known values like approx(rule =
+// 2). LINEAR is approx().
+void fill(const std::vector<int> &years, std::vector<double> &values,
+          const Method method);
+
+// Interpolates the variables var_idxs (0-indexed) of a division (every
+// division) over its observations, in place. Observations must be sorted by
+// year.
+void interpolate(Division &div, const std::vector<int> &var_idxs,
+                 const Method method = LINEAR);
+void interpolate(PlanData &plandata, const std::vector<int> &var_idxs,
+                 const Method method = LINEAR);
+
+} // namespace interpolation
+
+} // namespace plan_database
+
+#endif // INTERPOLATION_H
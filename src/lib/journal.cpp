@@ -0,0 +1,79 @@
+#include "journal.h"
+#include <ctime>
+
+namespace plan_database {
+
+LinkJournal::LinkJournal(const std::string &_path) : path(_path) {}
+
+void LinkJournal::load() {
+  entries.clear();
+  if (!std::ifstream(path).good())
+    return;
+
+  for (const std::vector<std::string> &tokens : csv::parse(path)) {
+    if (tokens.size() < 4)
+      throw std::runtime_error("ERROR: Invalid row in journal: " + path);
+
+    Entry entry;
+    entry.id = std::stoi(tokens[0]);
+    entry.base_id = tokens[1] == "no" ? NO_LINK : std::stoi(tokens[1]);
+    entry.timestamp = tokens[2];
+    entry.score = csv::empty(tokens[3]) ? EMPTY_NUM : std::stod(tokens[3]);
+    entries.insert_or_assign(entry.id, entry);
+  }
+}
+
+void LinkJournal::append(const int id, const int base_id, const double score) {
+  char timestamp[32];
+  const std::time_t now = std::time(nullptr);
+  std::strftime(timestamp, sizeof(timestamp), "%Y-%m-%dT%H:%M:%SZ",
+                std::gmtime(&now));
+  const Entry entry = {id, base_id, timestamp, score};
+
+  const bool exists = std::ifstream(path).good();
+  std::ofstream file(path, std::ios::app);
+  if (!file.is_open())
+    throw std::runtime_error("ERROR: Could not open journal: " + path);
+
+  if (!exists)
+    file << "id,base_id,timestamp,score" << std::endl;
+  file << entry.id << ","
+       << (base_id == NO_LINK ? "no" : std::to_string(base_id)) << ","
+       << entry.timestamp << ","
+       << (score == EMPTY_NUM ? EMPTY : csv::dtostr(score)) << std::endl;
+
+  entries.insert_or_assign(id, entry);
+}
+
+const LinkJournal::Entry *LinkJournal::find(const int id) const {
+  auto it = entries.find(id);
+  return it == entries.end() ? nullptr : &it->second;
+}
+
+int LinkJournal::size() const { return entries.size(); }
+
+int LinkJournal::apply(PlanData &plandata) const {
+  LinkageGraph graph;
+  for (const Division &div : plandata.divs) {
+    graph.add(div);
+  }
+
+  int n_linked = 0;
+  for (const auto &[id, entry] : entries) {
+    if (entry.base_id == NO_LINK)
+      continue;
+
+    if (graph.link(id, entry.base_id))
+      n_linked++;
+    else
+      std::cerr << "WARNING: Conflicting link (observations in the same year) "
+                   "skipped: { id: "
+                << id << ", base_id: " << entry.base_id << " }" << std::endl;
+  }
+
+  graph.apply(plandata);
+
+  return n_linked;
+}
+
+} // namespace plan_database
@@ -0,0 +1,45 @@
+#ifndef JOURNAL_H
+#define JOURNAL_H
+
+#include "linkage.h"
+#include "plandata.h"
+#include <map>
+#include <string>
+#include <vector>
+
+namespace plan_database {
+
+// Append-only journal of linkage decisions (division ID linked to a base ID,
+// or not linked), one CSV row per decision, written as soon as it is made.
+// Later decisions for a division override earlier ones.
+class LinkJournal {
+public:
+  static constexpr int NO_LINK = -1;
+
+  struct Entry {
+    int id, base_id;       // base_id: NO_LINK if the division is kept as is
+    std::string timestamp; // UTC, ISO 8601
+    double score;          // matching score of the decision (EMPTY_NUM: none)
+  };
+
+  LinkJournal(const std::string &_path);
+
+  // Replays the journal file (a missing file is an empty journal)
+  void load();
+  void append(const int id, const int base_id, const double score);
+  const Entry *find(const int id) const; // nullptr if undecided
+  int size() const;
+
+  // Links the divisions through a LinkageGraph (chains resolve to canonical
+  // IDs, divisions with the same ID are merged). Conflicting links are skipped
+  // with a warning. Returns the number of links made.
+  int apply(PlanData &plandata) const;
+
+private:
+  std::string path;
+  std::map<int, Entry> entries; // latest decision per division ID
+};
+
+} // namespace plan_database
+
+#endif // JOURNAL_H
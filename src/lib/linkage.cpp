@@ -0,0 +1,89 @@
+#include "linkage.h"
+
+namespace plan_database {
+
+int LinkageGraph::get_node(const int id) {
+  auto [it, inserted] = idxs.try_emplace(id, (int)parent.size());
+  if (inserted) {
+    parent.push_back(it->second);
+    size.push_back(1);
+    canonical.push_back(id);
+    years.push_back(0);
+  }
+
+  return it->second;
+}
+
+int LinkageGraph::find_root(int node) {
+  while (parent[node] != node) {
+    parent[node] = parent[parent[node]]; // Path halving
+    node = parent[node];
+  }
+
+  return node;
+}
+
+void LinkageGraph::add(const Division &div) {
+  const int root = find_root(get_node(div.id));
+  for (const Division::Observation &ob : div.obs) {
+    if (ob.year == NA)
+      continue; // No year to conflict on
+
+    const int bit = ob.year - MIN_YEAR;
+    if (bit < 0 || bit >= 64)
+      throw std::runtime_error("ERROR: Year out of range in linkage: " +
+                               std::to_string(ob.year));
+    years[root] |= (uint64_t)1 << bit;
+  }
+}
+
+bool LinkageGraph::link(const int id, const int base_id) {
+  int root = find_root(get_node(id));
+  int base_root = find_root(get_node(base_id));
+  if (root == base_root)
+    return true;
+
+  if (years[root] & years[base_root]) {
+    conflicts.push_back({id, base_id});
+    return false;
+  }
+
+  const int base_canonical = canonical[base_root];
+  if (size[root] > size[base_root])
+    std::swap(root, base_root);
+  parent[root] = base_root;
+  size[base_root] += size[root];
+  years[base_root] |= years[root];
+  canonical[base_root] = base_canonical;
+
+  return true;
+}
+
+int LinkageGraph::find(const int id) {
+  auto it = idxs.find(id);
+  return it == idxs.end() ? id : canonical[find_root(it->second)];
+}
+
+void LinkageGraph::apply(PlanData &plandata) {
+  for (Division &div : plandata.divs) {
+    div.id = find(div.id);
+  }
+  plandata.sort_divs();
+
+  // Merge consecutive divisions with the same ID
+  std::vector<Division> merged;
+  for (Division &div : plandata.divs) {
+    if (!merged.empty() && merged.back().id == div.id) {
+      std::vector<Division::Observation> &obs = merged.back().obs;
+      obs.insert(obs.end(), std::make_move_iterator(div.obs.begin()),
+                 std::make_move_iterator(div.obs.end()));
+      merged.back().sort_obs();
+    } else {
+      merged.push_back(std::move(div));
+    }
+  }
+
+  plandata.divs = std::move(merged);
+}
+
+} // namespace plan_database
@@ -0,0 +1,43 @@
+#ifndef LINKAGE_H
+#define LINKAGE_H
+
+#include "plandata.h"
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace plan_database {
+
+// Links between division IDs as a union-find forest (path compression, union
+// by size), so that chains of links (A to B, B to C) resolve to one canonical
+// ID: the one of the division first linked to. Every set keeps a bitmask of the
+// years with observations, and a link that would merge two observations of the
+// same year is refused as a conflict.
+class LinkageGraph {
+public:
+  // Registers the years of a division (several calls for one ID add up)
+  void add(const Division &div);
+  // Links id to base_id (canonical ID of the merged set: base_id's). Returns
+  // false, without linking, on a conflict.
+  bool link(const int id, const int base_id);
+  int find(const int id); // canonical ID (id itself if never linked)
+
+  // Sets every division's ID to its canonical ID and merges the divisions
+  // that end up with the same ID, in one pass (plus sorting)
+  void apply(PlanData &plandata);
+
+  std::vector<std::pair<int, int>> conflicts; // (id, base_id) refused
+
+private:
+  std::unordered_map<int, int> idxs; // division ID -> node
+  std::vector<int> parent, size, canonical;
+  std::vector<uint64_t> years; // bit year - MIN_YEAR
+
+  int get_node(const int id);
+  int find_root(int node);
+};
+
+} // namespace plan_database
+
+#endif // LINKAGE_H
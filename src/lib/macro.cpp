@@ -48,61 +48,205 @@ MacroData::Observation::parse_tokens(const std::vector<std::string> &tokens) {
   return ob;
 }
 
+std::vector<std::string> MacroData::Observation::tokenise() const {
+  // Full double precision, so that written values read back unchanged
+  auto scaled = [](const double val, const double scale) {
+    if (val == EMPTY_NUM)
+      return std::string(EMPTY);
+    char value_str[32];
+    std::snprintf(value_str, sizeof(value_str), "%.17g", val / scale);
+    return std::string(value_str);
+  };
+
+  return {get_industry_code(mkt_id),
+          std::to_string(year),
+          scaled(sales, 1e6),
+          scaled(input_cost, 1e6),
+          scaled(wage_sum, 1e6),
+          scaled(value_added, 1e6),
+          scaled(employees, 1e3),
+          scaled(manhours, 1e6),
+          scaled(gross_investments, 1e6)};
+}
+
+void MacroData::index() {
+  table.clear();
+  present.clear();
+  totals.clear();
+  present_totals.clear();
+  std::fill(std::begin(markets), std::end(markets), 0);
+
+  if (obs.empty()) {
+    year_low = 0;
+    year_high = -1;
+    return;
+  }
+
+  auto [min_it, max_it] = std::minmax_element(
+      obs.begin(), obs.end(),
+      [](const Observation &a, const Observation &b) { return a.year < b.year; });
+  year_low = min_it->year;
+  year_high = max_it->year;
+
+  const int n_years = year_high - year_low + 1;
+  table.resize(n_years * N_MKT_PLAN);
+  present.resize(n_years * N_MKT_PLAN, 0);
+  totals.resize(n_years);
+  present_totals.resize(n_years, 0);
+
+  for (const Observation &ob : obs) {
+    if (ob.mkt_id < 0 || ob.mkt_id >= N_MKT_PLAN)
+      throw std::runtime_error("ERROR: Invalid market in macro observation");
+
+    const int cell = (ob.year - year_low) * N_MKT_PLAN + ob.mkt_id;
+    table[cell] = ob;
+    present[cell] = 1;
+    markets[ob.mkt_id] = 1;
+  }
+
+  // All-market totals (NA-aware: one NA market makes the total NA)
+  auto add = [](double &sum, const double val) {
+    sum = (sum == EMPTY_NUM || val == EMPTY_NUM) ? EMPTY_NUM : sum + val;
+  };
+
+  for (int y = 0; y < n_years; y++) {
+    Observation total = {year_low + y, NO_MKT, 0, 0, 0, 0, 0, 0, 0, 0};
+    for (int mkt_id = 0; mkt_id < N_MKT_PLAN; mkt_id++) {
+      const int cell = y * N_MKT_PLAN + mkt_id;
+      if (!present[cell])
+        continue;
+
+      const Observation &ob = table[cell];
+      add(total.sales, ob.sales);
+      add(total.input_cost, ob.input_cost);
+      add(total.wage_sum, ob.wage_sum);
+      add(total.value_added, ob.value_added);
+      add(total.employees, ob.employees);
+      add(total.manhours, ob.manhours);
+      add(total.gross_investments, ob.gross_investments);
+      present_totals[y] = 1;
+    }
+
+    total.wage = (total.wage_sum == EMPTY_NUM || total.employees == EMPTY_NUM)
+                     ? EMPTY_NUM
+                     : total.wage_sum / total.employees;
+    totals[y] = total;
+  }
+}
+
+const MacroData::Observation *MacroData::get(const int year,
+                                             const int mkt_id) const {
+  if (year < year_low || year > year_high || mkt_id < 0 ||
+      mkt_id >= N_MKT_PLAN)
+    return nullptr;
+
+  const int cell = (year - year_low) * N_MKT_PLAN + mkt_id;
+  return present[cell] ? &table[cell] : nullptr;
+}
+
+const MacroData::Observation *MacroData::get_total(const int year) const {
+  if (year < year_low || year > year_high)
+    return nullptr;
+
+  return present_totals[year - year_low] ? &totals[year - year_low] : nullptr;
+}
+
+std::vector<int> MacroData::get_years() const {
+  std::vector<int> ret;
+  for (int year = year_low; year <= year_high; year++) {
+    if (present_totals[year - year_low])
+      ret.push_back(year);
+  }
+
+  return ret;
+}
+
 void MacroData::sort_obs() {
-  std::sort(obs.begin(), obs.end(),
-            [](const auto &a, const auto &b) { return a.year < b.year; });
+  std::sort(obs.begin(), obs.end(), [](const auto &a, const auto &b) {
+    return a.year < b.year || (a.year == b.year && a.mkt_id < b.mkt_id);
+  });
 }
 
 void MacroData::filter_interval(const int low, const int high) {
-  std::vector<Observation> filtered_obs;
-  for (Observation &ob : obs) {
-    if (ob.year <= high && ob.year >= low)
-      filtered_obs.push_back(ob);
-  }
+  obs.erase(std::remove_if(obs.begin(), obs.end(),
+                           [low, high](const Observation &ob) {
+                             return ob.year > high || ob.year < low;
+                           }),
+            obs.end());
 
-  obs = std::move(filtered_obs);
+  index();
 }
 
 void MacroData::filter_markets(const std::vector<int> &mkt_ids) {
-  std::vector<Observation> filtered_obs;
-  for (Observation &ob : obs) {
-    if (std::find(mkt_ids.begin(), mkt_ids.end(), ob.mkt_id) != mkt_ids.end())
-      filtered_obs.push_back(ob);
+  // Lookup mask instead of searching mkt_ids for every observation
+  char keep[N_MKT_PLAN] = {};
+  for (const int mkt_id : mkt_ids) {
+    if (mkt_id >= 0 && mkt_id < N_MKT_PLAN)
+      keep[mkt_id] = 1;
   }
 
-  obs = std::move(filtered_obs);
+  obs.erase(std::remove_if(obs.begin(), obs.end(),
+                           [&keep](const Observation &ob) {
+                             return ob.mkt_id < 0 || ob.mkt_id >= N_MKT_PLAN ||
+                                    !keep[ob.mkt_id];
+                           }),
+            obs.end());
+
+  index();
 }
 
 void MacroData::filter_years(const std::vector<int> &years) {
-  std::vector<Observation> filtered_obs;
-  for (Observation &ob : obs) {
-    if (std::find(years.begin(), years.end(), ob.year) != years.end())
-      filtered_obs.push_back(ob);
+  // Lookup mask over the indexed year range (rows outside it are dropped)
+  std::vector<char> keep(std::max(0, year_high - year_low + 1), 0);
+  for (const int year : years) {
+    if (year >= year_low && year <= year_high)
+      keep[year - year_low] = 1;
   }
 
-  obs = std::move(filtered_obs);
+  obs.erase(std::remove_if(obs.begin(), obs.end(),
+                           [this, &keep](const Observation &ob) {
+                             return ob.year < year_low ||
+                                    ob.year > year_high ||
+                                    !keep[ob.year - year_low];
+                           }),
+            obs.end());
+
+  index();
 }
 
 bool MacroData::has_market(const int mkt_id) const {
-  for (const Observation &ob : obs) {
-    if (ob.mkt_id == mkt_id)
-      return true;
-  }
-  return false;
+  if (mkt_id < 0 || mkt_id >= N_MKT_PLAN)
+    return false;
+
+  return markets[mkt_id];
 }
 
 void MacroData::parse_csv(const std::string &path, const char separator) {
   std::vector<std::vector<std::string>> rows = csv::parse(path, separator);
 
   obs = std::vector<Observation>();
+  obs.reserve(rows.size());
   for (const std::vector<std::string> &tokens : rows) {
     MacroData::Observation ob = MacroData::Observation::parse_tokens(tokens);
     obs.push_back(ob);
   }
 
   sort_obs();
+  index();
 }
 
-void MacroData::write_csv(const std::string &path, const char separator) {}
+void MacroData::write_csv(const std::string &path, const char separator) {
+  const std::vector<std::string> header = {
+      "industry",  "year",     "sales",    "input_cost",      "wage_sum",
+      "value_added", "employees", "manhours", "gross_investment"};
+
+  std::vector<std::vector<std::string>> rows;
+  rows.reserve(obs.size());
+  for (const Observation &ob : obs) {
+    rows.push_back(ob.tokenise());
+  }
+
+  csv::write(path, rows, separator, header);
+}
 
 } // namespace plan_database
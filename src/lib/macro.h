@@ -3,6 +3,8 @@
 
 #include "csv.h"
 #include "utility.h"
+#include <algorithm>
+#include <cstdio>
 #include <vector>
 
 namespace plan_database {
@@ -15,10 +17,27 @@ public:
         gross_investments;
 
     static Observation parse_tokens(const std::vector<std::string> &tokens);
+    std::vector<std::string> tokenise() const;
   };
 
   std::vector<Observation> obs; // Observations
 
+  // Dense (year x market) table over obs, rebuilt by index() whenever obs is
+  // parsed or filtered. Cell (year, mkt_id) is found at
+  // (year - year_low) * N_MKT_PLAN + mkt_id. totals holds the sum over all
+  // markets present in obs for each year (NA if any market's value is NA).
+  int year_low = 0, year_high = -1;
+  std::vector<Observation> table;
+  std::vector<char> present;
+  std::vector<Observation> totals;
+  std::vector<char> present_totals;
+  char markets[N_MKT_PLAN] = {};
+
+  void index();
+  const Observation *get(const int year, const int mkt_id) const;
+  const Observation *get_total(const int year) const;
+  std::vector<int> get_years() const;
+
   void sort_obs();
   void filter_interval(const int low, const int high);
   void filter_markets(const std::vector<int> &mkt_ids);
@@ -0,0 +1,100 @@
+#include "panel.h"
+
+namespace plan_database {
+
+FirmPanel::FirmPanel(const std::vector<Firm> &firms) {
+  // Year range
+  year_low = MAX_YEAR;
+  year_high = MIN_YEAR;
+  size_t n_rows = 0;
+  for (const Firm &firm : firms) {
+    for (const Firm::Observation &ob : firm.obs) {
+      year_low = std::min(year_low, ob.year);
+      year_high = std::max(year_high, ob.year);
+      n_rows++;
+    }
+  }
+
+  if (n_rows == 0) {
+    year_low = 0;
+    year_high = -1;
+    year_offsets = {0};
+    touch();
+    return;
+  }
+
+  // Count rows per year, then prefix sum into offsets (counting sort)
+  const int n_years = year_high - year_low + 1;
+  year_offsets.assign(n_years + 1, 0);
+  for (const Firm &firm : firms) {
+    for (const Firm::Observation &ob : firm.obs) {
+      year_offsets[ob.year - year_low + 1]++;
+    }
+  }
+  for (int i = 0; i < n_years; i++) {
+    year_offsets[i + 1] += year_offsets[i];
+  }
+
+  years.resize(n_rows);
+  firm_ids.resize(n_rows);
+  mkt_ids.resize(n_rows);
+  is_synthetic.resize(n_rows);
+  for (std::vector<double> &column : columns) {
+    column.resize(n_rows);
+  }
+
+  // Scatter observations into their year's rows
+  std::vector<int> next(year_offsets.begin(), year_offsets.end() - 1);
+  for (const Firm &firm : firms) {
+    for (const Firm::Observation &ob : firm.obs) {
+      const int row = next[ob.year - year_low]++;
+      years[row] = ob.year;
+      firm_ids[row] = firm.id;
+      mkt_ids[row] = firm.mkt_id;
+      is_synthetic[row] = firm.is_synthetic;
+      columns[EMPLOYEES][row] = ob.employees;
+      columns[SALES][row] = ob.sales;
+      columns[INPUT_COST][row] = ob.input_cost;
+      columns[WAGE_SUM][row] = ob.wage_sum;
+      columns[WAGE][row] = ob.wage;
+    }
+  }
+
+  touch();
+}
+
+FirmPanel FirmPanel::from_cross_sections(const PlanData &plandata,
+                                         const MacroData &macrodata,
+                                         const bool divide_synthetic) {
+  std::vector<Firm> firms;
+  for (int year = MIN_YEAR; year <= MAX_YEAR; year++) {
+    if (!macrodata.get_total(year))
+      continue;
+
+    std::vector<Firm> year_firms =
+        Firm::to_firms(plandata, macrodata, divide_synthetic, {year});
+    firms.insert(firms.end(), year_firms.begin(), year_firms.end());
+  }
+
+  return FirmPanel(firms);
+}
+
+size_t FirmPanel::size() const { return years.size(); }
+
+std::pair<int, int> FirmPanel::get_rows(const int year) const {
+  if (year < year_low || year > year_high)
+    return {0, 0};
+
+  return {year_offsets[year - year_low], year_offsets[year - year_low + 1]};
+}
+
+const std::vector<double> &FirmPanel::get_column(const Column column) const {
+  if (column < 0 || column >= N_COLUMNS)
+    throw std::runtime_error("ERROR: Invalid firm panel column");
+
+  return columns[column];
+}
+
+void FirmPanel::touch() { version = ++version_counter; }
+
+} // namespace plan_database
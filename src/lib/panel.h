@@ -0,0 +1,49 @@
+#ifndef PANEL_H
+#define PANEL_H
+
+#include "firm.h"
+#include "utility.h"
+#include <atomic>
+#include <string>
+#include <vector>
+
+namespace plan_database {
+
+// Columnar (structure of arrays) view of firms. Rows are firm observations,
+// sorted year-major: all rows of a year are contiguous and keep the order of
+// the firms they were built from.
+class FirmPanel {
+public:
+  enum Column { EMPLOYEES, SALES, INPUT_COST, WAGE_SUM, WAGE, N_COLUMNS };
+
+  std::vector<int> years, firm_ids, mkt_ids;
+  std::vector<char> is_synthetic;
+  std::vector<double> columns[N_COLUMNS];
+
+  int year_low = 0, year_high = -1;
+  std::vector<int> year_offsets; // rows of year y: [year_offsets[y - year_low],
+                                 // year_offsets[y - year_low + 1])
+
+  unsigned long version = 0; // changes whenever the rows change (touch())
+
+  FirmPanel() = default;
+  FirmPanel(const std::vector<Firm> &firms);
+
+  // Independent cross-sections of every year MIN_YEAR-MAX_YEAR with macro
+  // data (no selection across years) in one panel
+  static FirmPanel from_cross_sections(const PlanData &plandata,
+                                       const MacroData &macrodata,
+                                       const bool divide_synthetic);
+
+  size_t size() const;
+  std::pair<int, int> get_rows(const int year) const;
+  const std::vector<double> &get_column(const Column column) const;
+  void touch();
+
+private:
+  static inline std::atomic<unsigned long> version_counter = 0;
+};
+
+} // namespace plan_database
+
+#endif // PANEL_H
@@ -0,0 +1,39 @@
+#include "plan_columns.h"
+
+namespace plan_database {
+
+PlanColumns::PlanColumns(const PlanData &plandata) {
+  int n_rows = 0, n = 0;
+  for (const Division &div : plandata.divs) {
+    n_rows += div.obs.size();
+    for (const Division::Observation &ob : div.obs) {
+      n = std::max(n, (int)ob.vars.size());
+    }
+  }
+
+  ids.reserve(n_rows);
+  years.reserve(n_rows);
+  prev_rows.reserve(n_rows);
+  vars.assign(n, std::vector<double>(n_rows, EMPTY_NUM));
+
+  for (const Division &div : plandata.divs) {
+    for (int i = 0; i < div.obs.size(); i++) {
+      const Division::Observation &ob = div.obs[i];
+      const int row = ids.size();
+
+      ids.push_back(div.id);
+      years.push_back(ob.year);
+      prev_rows.push_back(i > 0 && div.obs[i - 1].year == ob.year - 1 ? row - 1
+                                                                      : -1);
+      for (int var = 0; var < ob.vars.size(); var++) {
+        vars[var][row] = ob.vars[var];
+      }
+    }
+  }
+}
+
+size_t PlanColumns::size() const { return ids.size(); }
+
+int PlanColumns::n_vars() const { return vars.size(); }
+
+} // namespace plan_database
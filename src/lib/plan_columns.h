@@ -0,0 +1,26 @@
+#ifndef PLAN_COLUMNS_H
+#define PLAN_COLUMNS_H
+
+#include "plandata.h"
+#include <vector>
+
+namespace plan_database {
+
+// Columnar (structure of arrays) copy of PlanData. Rows are observations in
+// division order (observations sorted by year), with one contiguous column per
+// variable.
+class PlanColumns {
+public:
+  std::vector<int> ids, years;
+  std::vector<int> prev_rows; // row of the division's previous year (-1: none)
+  std::vector<std::vector<double>> vars; // vars[var_idx][row]
+
+  PlanColumns(const PlanData &plandata);
+
+  size_t size() const;
+  int n_vars() const;
+};
+
+} // namespace plan_database
+
+#endif // PLAN_COLUMNS_H
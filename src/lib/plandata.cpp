@@ -8,6 +8,46 @@ void PlanData::sort_divs() {
             [](const auto &a, const auto &b) { return a.id < b.id; });
 }
 
+std::vector<std::pair<int, int>>
+PlanData::join_divs(const PlanData &other) const {
+  auto assert_sorted = [](const PlanData &data) {
+    for (int i = 1; i < data.divs.size(); i++) {
+      if (data.divs[i - 1].id >= data.divs[i].id)
+        throw std::runtime_error(
+            "ERROR: Divisions not sorted by unique id in join_divs(): { id: " +
+            std::to_string(data.divs[i].id) + " }");
+    }
+  };
+  assert_sorted(*this);
+  assert_sorted(other);
+
+  std::vector<std::pair<int, int>> pairs;
+  int i = 0, j = 0;
+  while (i < divs.size() && j < other.divs.size()) {
+    if (divs[i].id < other.divs[j].id) {
+      i++;
+    } else if (divs[i].id > other.divs[j].id) {
+      j++;
+    } else {
+      pairs.push_back({i++, j++});
+    }
+  }
+
+  return pairs;
+}
+
+long PlanData::overlay(const PlanData &other, const std::vector<int> &var_idxs,
+                       const bool only_between) {
+  long n_overwritten = 0;
+  for (const auto &[div_idx, other_idx] : join_divs(other)) {
+    n_overwritten +=
+        divs[div_idx].overlay(other.divs[other_idx], var_idxs, only_between)
+            .size();
+  }
+
+  return n_overwritten;
+}
+
 void PlanData::filter_markets(const std::vector<int> &mkt_ids) {
   std::vector<Division> filtered_divs;
   for (const Division &div : divs) {
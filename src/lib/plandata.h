@@ -16,6 +16,14 @@ public:
   void filter_markets(const std::vector<int> &mkt_ids);
   void filter_interval(const int low, const int high, const bool hard);
   void filter_years(const std::vector<int> &years);
+  // Index pairs (this, other) of divisions with the same id, in one merge pass
+  // over both (sorted by id, see sort_divs())
+  std::vector<std::pair<int, int>> join_divs(const PlanData &other) const;
+  // Overlays other's non-NA values of var_idxs onto NA values of the
+  // observation with the same (id, year), see Division::overlay(). Returns the
+  // number of overwritten values.
+  long overlay(const PlanData &other, const std::vector<int> &var_idxs,
+               const bool only_between = false);
 
   void parse_csv(const std::string &path, const char separator = ',',
                  const bool full_data = false);
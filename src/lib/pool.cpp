@@ -0,0 +1,142 @@
+#include "pool.h"
+
+namespace plan_database {
+
+ThreadPool::ThreadPool(const int n_threads) {
+  int n = n_threads > 0 ? n_threads : (int)std::thread::hardware_concurrency();
+  if (n < 1)
+    n = 1;
+
+  for (int i = 0; i < n; i++) {
+    workers.emplace_back(&ThreadPool::work, this);
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stop = true;
+  }
+  cv.notify_all();
+
+  for (std::thread &worker : workers) {
+    worker.join();
+  }
+}
+
+int ThreadPool::size() const { return (int)workers.size(); }
+
+void ThreadPool::submit(std::function<void()> task) {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    tasks.push(std::move(task));
+  }
+  cv.notify_one();
+}
+
+void ThreadPool::work() {
+  while (true) {
+    std::function<void()> task;
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      cv.wait(lock, [this] { return stop || !tasks.empty(); });
+      if (stop && tasks.empty())
+        return;
+
+      task = std::move(tasks.front());
+      tasks.pop();
+    }
+
+    task();
+  }
+}
+
+void ThreadPool::parallel_for(const int n, const std::function<void(int)> &fn) {
+  if (n <= 0)
+    return;
+
+  // Every worker starts on its own contiguous range of indices and, when it
+  // runs out, steals the upper half of the largest remaining range
+  struct Range {
+    std::mutex mutex;
+    int begin, end;
+  };
+  const int n_running = std::min(n, size());
+  std::vector<Range> ranges(n_running);
+  for (int t = 0; t < n_running; t++) {
+    ranges[t].begin = (int)((long)n * t / n_running);
+    ranges[t].end = (int)((long)n * (t + 1) / n_running);
+  }
+
+  auto steal = [&ranges, n_running](const int t) {
+    int victim = -1, max_left = 0;
+    for (int v = 0; v < n_running; v++) {
+      std::lock_guard<std::mutex> lock(ranges[v].mutex);
+      if (ranges[v].end - ranges[v].begin > max_left) {
+        max_left = ranges[v].end - ranges[v].begin;
+        victim = v;
+      }
+    }
+    if (victim == -1)
+      return false;
+
+    int begin, end;
+    {
+      std::lock_guard<std::mutex> lock(ranges[victim].mutex);
+      const int left = ranges[victim].end - ranges[victim].begin;
+      if (left <= 0)
+        return true; // Taken meanwhile, look again
+      end = ranges[victim].end;
+      begin = end - std::max(left / 2, 1);
+      ranges[victim].end = begin;
+    }
+
+    std::lock_guard<std::mutex> lock(ranges[t].mutex);
+    ranges[t].begin = begin;
+    ranges[t].end = end;
+    return true;
+  };
+
+  std::exception_ptr error = nullptr;
+  std::mutex done_mutex;
+  std::condition_variable done_cv;
+  int n_left = n_running;
+
+  for (int t = 0; t < n_running; t++) {
+    submit([&, t] {
+      while (true) {
+        int i = -1;
+        {
+          std::lock_guard<std::mutex> lock(ranges[t].mutex);
+          if (ranges[t].begin < ranges[t].end)
+            i = ranges[t].begin++;
+        }
+        if (i == -1) {
+          if (steal(t))
+            continue;
+          break;
+        }
+
+        try {
+          fn(i);
+        } catch (...) {
+          std::lock_guard<std::mutex> lock(done_mutex);
+          if (!error)
+            error = std::current_exception();
+        }
+      }
+
+      std::lock_guard<std::mutex> lock(done_mutex);
+      if (--n_left == 0)
+        done_cv.notify_one();
+    });
+  }
+
+  std::unique_lock<std::mutex> lock(done_mutex);
+  done_cv.wait(lock, [&] { return n_left == 0; });
+
+  if (error)
+    std::rethrow_exception(error);
+}
+
+} // namespace plan_database
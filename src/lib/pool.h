@@ -0,0 +1,43 @@
+#ifndef POOL_H
+#define POOL_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+namespace plan_database {
+
+// Fixed-size pool of worker threads. parallel_for() blocks until every index
+// has been processed (work-stealing over index ranges) and rethrows the first
+// exception thrown by fn.
+class ThreadPool {
+public:
+  ThreadPool(const int n_threads = 0); // 0: one thread per hardware thread
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+
+  int size() const;
+  void parallel_for(const int n, const std::function<void(int)> &fn);
+
+private:
+  std::vector<std::thread> workers;
+  std::queue<std::function<void()>> tasks;
+  std::mutex mutex;
+  std::condition_variable cv;
+  bool stop = false;
+
+  void submit(std::function<void()> task);
+  void work();
+};
+
+} // namespace plan_database
+
+#endif // POOL_H
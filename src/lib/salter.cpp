@@ -0,0 +1,239 @@
+#include "salter.h"
+
+namespace plan_database {
+
+SalterCurve::SalterCurve(const std::vector<double> &_weights,
+                         const std::vector<double> &heights,
+                         const std::vector<char> &_marked, const bool sort) {
+  if (_weights.size() != heights.size() ||
+      (!_marked.empty() && _marked.size() != heights.size()))
+    throw std::runtime_error("ERROR: Salter curve columns differ in length");
+
+  const int n = (int)heights.size();
+  index.resize(n);
+  std::iota(index.begin(), index.end(), 0);
+
+  // Sort by height (descending), ties keep input order
+  if (sort)
+    std::stable_sort(index.begin(), index.end(), [&heights](int a, int b) {
+      return heights[a] > heights[b];
+    });
+
+  gather(_weights, heights, _marked);
+}
+
+SalterCurve::SalterCurve(const std::vector<double> &_weights,
+                         const std::vector<double> &heights,
+                         const std::vector<char> &_marked,
+                         const std::vector<int> &order) {
+  if (_weights.size() != heights.size() ||
+      (!_marked.empty() && _marked.size() != heights.size()) ||
+      order.size() != heights.size())
+    throw std::runtime_error("ERROR: Salter curve columns differ in length");
+
+  const int n = (int)heights.size();
+  index = order;
+
+  // Height (descending), then input order: the stable sort's order
+  auto before = [&heights](int a, int b) {
+    return heights[a] > heights[b] || (heights[a] == heights[b] && a < b);
+  };
+
+  // Insertion sort, given up once it moves more than a full sort would
+  const long max_moves = 8L * n + 64;
+  long moves = 0;
+  for (int i = 1; i < n && moves <= max_moves; i++) {
+    const int idx = index[i];
+    int j = i;
+    for (; j > 0 && before(idx, index[j - 1]); j--) {
+      index[j] = index[j - 1];
+    }
+    index[j] = idx;
+    moves += i - j;
+  }
+  if (moves > max_moves)
+    std::sort(index.begin(), index.end(), before);
+
+  gather(_weights, heights, _marked);
+}
+
+void SalterCurve::gather(const std::vector<double> &_weights,
+                         const std::vector<double> &heights,
+                         const std::vector<char> &_marked) {
+  const int n = (int)index.size();
+  weights.resize(n);
+  y.resize(n);
+  marked.resize(n, 0);
+  for (int i = 0; i < n; i++) {
+    weights[i] = _weights[index[i]];
+    y[i] = heights[index[i]];
+    if (!_marked.empty())
+      marked[i] = _marked[index[i]];
+  }
+
+  accumulate();
+}
+
+SalterCurve SalterCurve::from_panel(const FirmPanel &panel,
+                                    const std::vector<double> &weights,
+                                    const std::vector<double> &heights,
+                                    const int year, const int mkt_id,
+                                    const SalterCurve *previous) {
+  // Gather the cross-section
+  std::vector<int> rows;
+  std::vector<double> cs_weights, cs_heights;
+  std::vector<char> cs_marked;
+
+  auto [begin, end] = panel.get_rows(year);
+  for (int row = begin; row < end; row++) {
+    if (mkt_id != NO_MKT && panel.mkt_ids[row] != mkt_id)
+      continue;
+
+    rows.push_back(row);
+    cs_weights.push_back(weights[row]);
+    cs_heights.push_back(heights[row]);
+    cs_marked.push_back(panel.is_synthetic[row]);
+  }
+
+  SalterCurve curve;
+  if (previous == nullptr) {
+    curve = SalterCurve(cs_weights, cs_heights, cs_marked);
+  } else {
+    // Seed with the previous curve's ranks of the same firms, new firms last
+    std::unordered_map<int, int> positions; // firm id -> cross-section index
+    for (int i = (int)rows.size() - 1; i >= 0; i--) {
+      positions[panel.firm_ids[rows[i]]] = i;
+    }
+
+    std::vector<int> order;
+    std::vector<char> is_placed(rows.size(), 0);
+    order.reserve(rows.size());
+    for (const int row : previous->index) {
+      auto it = positions.find(panel.firm_ids[row]);
+      if (it != positions.end() && !is_placed[it->second]) {
+        order.push_back(it->second);
+        is_placed[it->second] = 1;
+      }
+    }
+    for (int i = 0; i < (int)rows.size(); i++) {
+      if (!is_placed[i])
+        order.push_back(i);
+    }
+
+    curve = SalterCurve(cs_weights, cs_heights, cs_marked, order);
+  }
+
+  // Refer steps back to panel rows
+  for (int &idx : curve.index) {
+    idx = rows[idx];
+  }
+
+  return curve;
+}
+
+void SalterCurve::accumulate() {
+  const int n = (int)weights.size();
+  x_low.resize(n);
+  x_high.resize(n);
+
+  double total = 0.0;
+  for (const double weight : weights) {
+    total += weight;
+  }
+
+  double cum = 0.0;
+  for (int i = 0; i < n; i++) {
+    x_low[i] = cum;
+    cum += 100 * weights[i] / total;
+    x_high[i] = cum;
+  }
+}
+
+size_t SalterCurve::size() const { return y.size(); }
+
+std::vector<double> SalterCurve::align(const std::vector<double> &values) const {
+  // Reorder values (indexed like the input, or by panel row) into step order
+  std::vector<double> ret(index.size());
+  for (size_t i = 0; i < index.size(); i++) {
+    ret[i] = values[index[i]];
+  }
+
+  return ret;
+}
+
+SalterCurve SalterCurve::aligned(const std::vector<double> &values) const {
+  // Same steps and widths, heights taken from another variable
+  SalterCurve curve = *this;
+  curve.y = align(values);
+  return curve;
+}
+
+std::vector<std::vector<std::string>> SalterCurve::tokenise() const {
+  std::vector<std::vector<std::string>> rows;
+  rows.reserve(size());
+  for (size_t i = 0; i < size(); i++) {
+    rows.push_back({std::to_string(i), std::to_string(index[i]),
+                    csv::dtostr(weights[i]), csv::dtostr(x_low[i]),
+                    csv::dtostr(x_high[i]), csv::dtostr(y[i]),
+                    std::to_string((int)marked[i])});
+  }
+
+  return rows;
+}
+
+void SalterCurve::write_csv(const std::string &path,
+                            const char separator) const {
+  csv::write(path, tokenise(), separator, header);
+}
+
+void SalterCurve::write_binary(const std::string &path) const {
+  // Layout: "SALTER01", uint64 n, then the arrays index (int32), weights,
+  // y, x_low, x_high (float64) and marked (int8)
+  std::ofstream file(path, std::ios::binary);
+  if (!file.is_open())
+    throw std::runtime_error(
+        "ERROR: Could not open file to write salter curve to: " + path);
+
+  const uint64_t n = size();
+  file.write("SALTER01", 8);
+  file.write(reinterpret_cast<const char *>(&n), sizeof(n));
+  file.write(reinterpret_cast<const char *>(index.data()), n * sizeof(int));
+  for (const std::vector<double> *v : {&weights, &y, &x_low, &x_high}) {
+    file.write(reinterpret_cast<const char *>(v->data()), n * sizeof(double));
+  }
+  file.write(marked.data(), n);
+
+  if (!file)
+    throw std::runtime_error("ERROR: Could not write salter curve to: " + path);
+}
+
+SalterCurve SalterCurve::read_binary(const std::string &path) {
+  std::ifstream file(path, std::ios::binary);
+  if (!file.is_open())
+    throw std::runtime_error("ERROR: Could not open file: " + path);
+
+  char magic[8];
+  uint64_t n = 0;
+  file.read(magic, 8);
+  file.read(reinterpret_cast<char *>(&n), sizeof(n));
+  if (!file || std::string(magic, 8) != "SALTER01")
+    throw std::runtime_error("ERROR: Not a salter curve file: " + path);
+
+  SalterCurve curve;
+  curve.index.resize(n);
+  file.read(reinterpret_cast<char *>(curve.index.data()), n * sizeof(int));
+  for (std::vector<double> *v :
+       {&curve.weights, &curve.y, &curve.x_low, &curve.x_high}) {
+    v->resize(n);
+    file.read(reinterpret_cast<char *>(v->data()), n * sizeof(double));
+  }
+  curve.marked.resize(n);
+  file.read(curve.marked.data(), n);
+
+  if (!file)
+    throw std::runtime_error("ERROR: Truncated salter curve file: " + path);
+
+  return curve;
+}
+
+} // namespace plan_database
@@ -0,0 +1,65 @@
+#ifndef SALTER_H
+#define SALTER_H
+
+#include "csv.h"
+#include "panel.h"
+#include "utility.h"
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace plan_database {
+
+// Salter curve of a cross-section as a step function: one step per firm,
+// sorted by descending height. Step i has height y[i] and spans
+// [x_low[i], x_high[i]) in % of the cross-section's total weight.
+// No Qt dependency: Graph draws from it, batch jobs export it.
+class SalterCurve {
+public:
+  std::vector<int> index; // input index (or panel row) of each step
+  std::vector<double> weights, y, x_low, x_high;
+  std::vector<char> marked;
+
+  SalterCurve() = default;
+  SalterCurve(const std::vector<double> &_weights,
+              const std::vector<double> &heights,
+              const std::vector<char> &_marked = std::vector<char>(),
+              const bool sort = true);
+  // Sorted from an initial order (a permutation of the input), e.g. the ranks
+  // of the same firms in the previous year: insertion sort while the order
+  // is close, full sort otherwise. Same result as the sorting constructor.
+  SalterCurve(const std::vector<double> &_weights,
+              const std::vector<double> &heights,
+              const std::vector<char> &_marked, const std::vector<int> &order);
+
+  static SalterCurve from_panel(const FirmPanel &panel,
+                                const std::vector<double> &weights,
+                                const std::vector<double> &heights,
+                                const int year, const int mkt_id = NO_MKT,
+                                const SalterCurve *previous = nullptr);
+
+  size_t size() const;
+  std::vector<double> align(const std::vector<double> &values) const;
+  SalterCurve aligned(const std::vector<double> &values) const;
+
+  std::vector<std::vector<std::string>> tokenise() const;
+  void write_csv(const std::string &path, const char separator = ',') const;
+  void write_binary(const std::string &path) const;
+  static SalterCurve read_binary(const std::string &path);
+
+  static inline const std::vector<std::string> header = {
+      "rank", "index", "weight", "x_low", "x_high", "y", "marked"};
+
+private:
+  void gather(const std::vector<double> &_weights,
+              const std::vector<double> &heights,
+              const std::vector<char> &_marked);
+  void accumulate();
+};
+
+} // namespace plan_database
+
+#endif // SALTER_H
@@ -0,0 +1,233 @@
+#include "salter_stats.h"
+
+namespace plan_database {
+
+double SalterSummary::weighted_quantile(const std::vector<double> &values,
+                                        const std::vector<double> &weights,
+                                        const double q) {
+  // Smallest value whose cumulative weight (ascending) reaches q of the total.
+  // Weighted quickselect: nth_element partitions around the middle element
+  // and only the side holding the target weight is kept, O(n) on average.
+  const int n = (int)values.size();
+  if (n == 0)
+    return NA;
+
+  std::vector<int> idx(n);
+  std::iota(idx.begin(), idx.end(), 0);
+
+  auto weight = [&weights](const int i) { return std::max(0.0, weights[i]); };
+
+  double total = 0.0;
+  for (int i = 0; i < n; i++) {
+    total += weight(i);
+  }
+  const double target = q * total;
+
+  auto cmp = [&values](int a, int b) { return values[a] < values[b]; };
+
+  int lo = 0, hi = n;
+  double acc = 0.0; // weight of everything left of lo
+  while (hi - lo > 1) {
+    const int mid = lo + (hi - lo) / 2;
+    std::nth_element(idx.begin() + lo, idx.begin() + mid, idx.begin() + hi,
+                     cmp);
+
+    double left = 0.0;
+    for (int i = lo; i < mid; i++) {
+      left += weight(idx[i]);
+    }
+
+    if (acc + left >= target) {
+      hi = mid;
+    } else if (acc + left + weight(idx[mid]) >= target) {
+      return values[idx[mid]];
+    } else {
+      acc += left + weight(idx[mid]);
+      lo = mid + 1;
+    }
+  }
+
+  if (lo >= n) // Only rounding in the weight sums can get here
+    return *std::max_element(values.begin(), values.end());
+
+  return values[idx[lo]];
+}
+
+std::vector<double>
+SalterSummary::weighted_quantiles(const std::vector<double> &values,
+                                  const std::vector<double> &weights,
+                                  const std::vector<double> &qs) {
+  std::vector<double> ret;
+  ret.reserve(qs.size());
+  for (const double q : qs) {
+    ret.push_back(weighted_quantile(values, weights, q));
+  }
+
+  return ret;
+}
+
+std::vector<double> SalterSummary::find_crossings(const SalterCurve &prod,
+                                                  const SalterCurve &wage) {
+  // prod and wage must share the step order (SalterCurve::aligned(), or the
+  // series from to_aligned_prod_wage_series())
+  if (prod.size() != wage.size())
+    throw std::runtime_error("ERROR: Salter curves are not aligned");
+
+  std::vector<double> ret;
+  int prev_sign = 0;
+  for (size_t i = 0; i < prod.size(); i++) {
+    const double diff = prod.y[i] - wage.y[i];
+    const int sign = (diff > 0) - (diff < 0);
+    if (sign == 0)
+      continue;
+
+    if (prev_sign != 0 && sign != prev_sign)
+      ret.push_back(prod.x_low[i]);
+    prev_sign = sign;
+  }
+
+  return ret;
+}
+
+SalterSummary SalterSummary::summarise(const std::vector<double> &values,
+                                       const std::vector<double> &weights,
+                                       const std::vector<double> &wages) {
+  SalterSummary summary;
+  summary.n = (int)values.size();
+  if (summary.n == 0)
+    return summary;
+
+  double weighted_sum = 0.0, weight_below_wage = 0.0;
+  summary.best_practice = values[0];
+  for (int i = 0; i < summary.n; i++) {
+    const double weight = std::max(0.0, weights[i]);
+    summary.total_weight += weight;
+    weighted_sum += weight * values[i];
+    summary.best_practice = std::max(summary.best_practice, values[i]);
+    if (!wages.empty() && values[i] < wages[i])
+      weight_below_wage += weight;
+  }
+  if (summary.total_weight <= 0)
+    return summary;
+
+  summary.mean = weighted_sum / summary.total_weight;
+  summary.best_practice_ratio = summary.best_practice / summary.mean;
+  if (!wages.empty())
+    summary.share_below_wage = 100 * weight_below_wage / summary.total_weight;
+
+  summary.quantiles = weighted_quantiles(values, weights, SALTER_QUANTILES);
+  const auto median_it =
+      std::find(SALTER_QUANTILES.begin(), SALTER_QUANTILES.end(), 0.5);
+  summary.median =
+      median_it != SALTER_QUANTILES.end()
+          ? summary.quantiles[median_it - SALTER_QUANTILES.begin()]
+          : weighted_quantile(values, weights, 0.5);
+
+  return summary;
+}
+
+std::vector<SalterSummary> SalterSummary::summarise_all(
+    const FirmPanel &panel, DerivedVariables &derived,
+    const std::string &variant, const std::vector<int> &years,
+    const std::vector<int> &mkt_ids, const bool with_crossings) {
+  const std::vector<double> &x = derived.evaluate(panel, "value_added");
+  const std::vector<double> &values = derived.evaluate(panel, variant);
+  const std::vector<double> &wages = derived.evaluate(panel, "wage_cost");
+
+  std::vector<SalterSummary> summaries;
+  std::vector<double> cs_values, cs_weights, cs_wages;
+  for (const int year : years) {
+    auto [begin, end] = panel.get_rows(year);
+
+    for (const int mkt_id : mkt_ids) {
+      // Gather cross-section
+      cs_values.clear();
+      cs_weights.clear();
+      cs_wages.clear();
+      for (int row = begin; row < end; row++) {
+        if (mkt_id != NO_MKT && panel.mkt_ids[row] != mkt_id)
+          continue;
+
+        cs_values.push_back(values[row]);
+        cs_weights.push_back(x[row]);
+        cs_wages.push_back(wages[row]);
+      }
+
+      if (cs_values.empty())
+        continue;
+
+      SalterSummary summary = summarise(cs_values, cs_weights, cs_wages);
+      summary.variant = variant;
+      summary.year = year;
+      summary.mkt_id = mkt_id;
+
+      // Crossings need the curve's step order
+      if (with_crossings) {
+        SalterCurve curve = SalterCurve::from_panel(panel, x, values, year,
+                                                    mkt_id);
+        summary.crossings = find_crossings(curve, curve.aligned(wages));
+      }
+
+      summaries.push_back(std::move(summary));
+    }
+  }
+
+  return summaries;
+}
+
+std::vector<std::string> SalterSummary::get_header() {
+  std::vector<std::string> header = {
+      "variant", "industry",      "year",          "n",
+      "weight",  "mean",          "median",        "best_practice",
+      "best_practice_ratio",      "share_below_wage"};
+  for (const double q : SALTER_QUANTILES) {
+    header.push_back("q" + csv::dtostr(100 * q));
+  }
+  header.push_back("crossings");
+
+  return header;
+}
+
+std::vector<std::string> SalterSummary::tokenise() const {
+  auto num = [](const double val) {
+    return val == NA ? std::string(EMPTY) : csv::dtostr(val);
+  };
+
+  std::vector<std::string> tokens = {
+      variant,
+      mkt_id == NO_MKT ? "ALL" : get_industry_code(mkt_id),
+      std::to_string(year),
+      std::to_string(n),
+      num(total_weight),
+      num(mean),
+      num(median),
+      num(best_practice),
+      num(best_practice_ratio),
+      num(share_below_wage)};
+  for (size_t i = 0; i < SALTER_QUANTILES.size(); i++) {
+    tokens.push_back(i < quantiles.size() ? num(quantiles[i]) : EMPTY);
+  }
+
+  // Crossing x positions separated by spaces
+  std::string crossings_str;
+  for (const double crossing : crossings) {
+    crossings_str += (crossings_str.empty() ? "" : " ") + csv::dtostr(crossing);
+  }
+  tokens.push_back(crossings_str.empty() ? EMPTY : crossings_str);
+
+  return tokens;
+}
+
+void SalterSummary::write_csv(const std::string &path,
+                              const std::vector<SalterSummary> &summaries,
+                              const char separator) {
+  std::vector<std::vector<std::string>> rows;
+  rows.reserve(summaries.size());
+  for (const SalterSummary &summary : summaries) {
+    rows.push_back(summary.tokenise());
+  }
+
+  csv::write(path, rows, separator, get_header());
+}
+
+} // namespace plan_database
@@ -0,0 +1,60 @@
+#ifndef SALTER_STATS_H
+#define SALTER_STATS_H
+
+#include "derived.h"
+#include "panel.h"
+#include "salter.h"
+#include "utility.h"
+#include <string>
+#include <vector>
+
+namespace plan_database {
+
+static const std::vector<double> SALTER_QUANTILES = {0.1, 0.25, 0.5, 0.75,
+                                                     0.9};
+
+// Distribution summary of one salter curve (cross-section). Quantiles are
+// weighted by the curve's weights and found by selection, not by sorting.
+// Negative weights (negative value added) are clamped to 0: such firms count
+// in n but not in the weight, mean, shares or quantiles.
+class SalterSummary {
+public:
+  std::string variant;
+  int year = NA, mkt_id = NO_MKT, n = 0;
+  double total_weight = 0.0, mean = NA, median = NA, best_practice = NA,
+         best_practice_ratio = NA, share_below_wage = NA;
+  std::vector<double> quantiles; // at SALTER_QUANTILES
+  std::vector<double> crossings; // x (% of weight) where the curve crosses
+                                 // the wage line
+
+  static double weighted_quantile(const std::vector<double> &values,
+                                  const std::vector<double> &weights,
+                                  const double q);
+  static std::vector<double>
+  weighted_quantiles(const std::vector<double> &values,
+                     const std::vector<double> &weights,
+                     const std::vector<double> &qs);
+  static std::vector<double> find_crossings(const SalterCurve &prod,
+                                            const SalterCurve &wage);
+
+  static SalterSummary
+  summarise(const std::vector<double> &values,
+            const std::vector<double> &weights,
+            const std::vector<double> &wages = std::vector<double>());
+
+  static std::vector<SalterSummary>
+  summarise_all(const FirmPanel &panel, DerivedVariables &derived,
+                const std::string &variant, const std::vector<int> &years,
+                const std::vector<int> &mkt_ids,
+                const bool with_crossings = true);
+
+  std::vector<std::string> tokenise() const;
+  static std::vector<std::string> get_header();
+  static void write_csv(const std::string &path,
+                        const std::vector<SalterSummary> &summaries,
+                        const char separator = ',');
+};
+
+} // namespace plan_database
+
+#endif // SALTER_STATS_H
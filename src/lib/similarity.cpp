@@ -0,0 +1,103 @@
+#include "similarity.h"
+#include <cctype>
+
+namespace plan_database {
+
+namespace similarity {
+
+// ASCII of the Latin-1 letters U+00C0 to U+00FF (" ": not a letter)
+static const char *latin1_folds[64] = {
+    "A", "A", "A", "A", "A", "A", "AE", "C", "E", "E", "E", "E", "I",
+    "I", "I", "I", "D", "N", "O", "O", "O", "O", "O", " ", "O", "U",
+    "U", "U", "U", "Y", "TH", "SS", "A", "A", "A", "A", "A", "A", "AE",
+    "C", "E", "E", "E", "E", "I", "I", "I", "I", "D", "N", "O", "O",
+    "O", "O", "O", " ", "O", "U", "U", "U", "U", "Y", "TH", "Y"};
+
+std::string fold(const std::string &str) {
+  std::string folded;
+  folded.reserve(str.size());
+
+  for (int i = 0; i < str.size(); i++) {
+    const unsigned char c = str[i];
+    if (c < 0x80) {
+      folded += std::isalnum(c) ? (char)std::toupper(c) : ' ';
+      continue;
+    }
+
+    // Two-byte UTF-8 sequence of U+00C0 to U+00FF, other characters dropped
+    if (c == 0xC3 && i + 1 < str.size()) {
+      const unsigned char next = str[i + 1];
+      if (next >= 0x80 && next <= 0xBF) {
+        folded += latin1_folds[next - 0x80];
+        i++;
+        continue;
+      }
+    }
+    folded += ' ';
+  }
+
+  return folded;
+}
+
+std::vector<std::string> fold_tokens(const std::string &str) {
+  std::vector<std::string> tokens;
+  std::string token;
+  for (const char c : fold(str) + " ") {
+    if (c != ' ') {
+      token += c;
+    } else if (!token.empty()) {
+      tokens.push_back(token);
+      token.clear();
+    }
+  }
+
+  return tokens;
+}
+
+Signature signature(const std::vector<std::string> &tokens) {
+  Signature sig;
+  for (const std::string &token : tokens) {
+    const std::string padded = " " + token + " ";
+    for (int i = 0; i + 3 <= padded.size(); i++) {
+      const int bit = fnv1a(padded.data() + i, 3) % SIGNATURE_BITS;
+      sig.words[bit / 64] |= (uint64_t)1 << (bit % 64);
+    }
+  }
+
+  for (const uint64_t word : sig.words) {
+    sig.count += __builtin_popcountll(word);
+  }
+
+  return sig;
+}
+
+Signature signature(const std::string &name) {
+  return signature(fold_tokens(name));
+}
+
+std::vector<int> get_bits(const Signature &sig) {
+  std::vector<int> bits;
+  for (int w = 0; w < SIGNATURE_BITS / 64; w++) {
+    uint64_t word = sig.words[w];
+    while (word) {
+      bits.push_back(w * 64 + __builtin_ctzll(word));
+      word &= word - 1;
+    }
+  }
+
+  return bits;
+}
+
+double jaccard(const Signature &a, const Signature &b) {
+  int n_and = 0;
+  for (int w = 0; w < SIGNATURE_BITS / 64; w++) {
+    n_and += __builtin_popcountll(a.words[w] & b.words[w]);
+  }
+
+  const int n_or = a.count + b.count - n_and;
+  return n_or == 0 ? 0.0 : (double)n_and / n_or;
+}
+
+} // namespace similarity
+
+} // namespace plan_database
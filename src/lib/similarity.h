@@ -0,0 +1,40 @@
+#ifndef SIMILARITY_H
+#define SIMILARITY_H
+
+#include "utility.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#define SIGNATURE_BITS 512 // Bits of a name signature (multiple of 64)
+
+namespace plan_database {
+
+namespace similarity {
+
+// Set of the character 3-grams of a name's tokens (padded with a space at both
+// ends, so "SANDVIK" and "SANDVIKEN" share " SA" to "VIK"), hashed into
+// SIGNATURE_BITS bits. Comparing two signatures is a few word operations.
+struct Signature {
+  uint64_t words[SIGNATURE_BITS / 64] = {};
+  int count = 0; // bits set
+};
+
+// Uppercase ASCII: Latin-1 letters folded to their base letters (Å, Ä to A, Ö
+// to O, É to E, ...), anything else that is not alphanumeric to a space
+std::string fold(const std::string &str);
+// Tokens of the folded string, split on spaces
+std::vector<std::string> fold_tokens(const std::string &str);
+
+Signature signature(const std::vector<std::string> &tokens);
+Signature signature(const std::string &name); // of fold_tokens(name)
+std::vector<int> get_bits(const Signature &sig);
+
+// Jaccard similarity of the 3-gram sets (0 to 1, 0 if both are empty)
+double jaccard(const Signature &a, const Signature &b);
+
+} // namespace similarity
+
+} // namespace plan_database
+
+#endif // SIMILARITY_H
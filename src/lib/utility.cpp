@@ -33,4 +33,58 @@ std::string get_industry_name(const int mkt_id) {
   return "NA";
 }
 
+std::string get_industry_code(const int mkt_id) {
+  if (mkt_id == CONSTR)
+    return "B";
+  else if (mkt_id == IMED)
+    return "S";
+  else if (mkt_id == RAW)
+    return "R";
+  else if (mkt_id == NDUR)
+    return "K";
+  else if (mkt_id == DUR)
+    return "V";
+
+  throw std::runtime_error("ERROR: Invalid market id");
+}
+
+uint64_t fnv1a(const void *data, const size_t size, const uint64_t hash) {
+  const unsigned char *bytes = (const unsigned char *)data;
+  uint64_t h = hash;
+  for (size_t i = 0; i < size; i++) {
+    h ^= bytes[i];
+    h *= 1099511628211ULL; // FNV prime
+  }
+
+  return h;
+}
+
+uint64_t fnv1a(const std::string &str, const uint64_t hash) {
+  // Length first, so that consecutive strings hash unambiguously
+  const uint64_t size = str.size();
+  return fnv1a(str.data(), str.size(), fnv1a(&size, sizeof(size), hash));
+}
+
+double median(std::vector<double> values) {
+  const int mid = values.size() / 2;
+  std::nth_element(values.begin(), values.begin() + mid, values.end());
+  if (values.size() % 2)
+    return values[mid];
+
+  const double upper = values[mid];
+  return (*std::max_element(values.begin(), values.begin() + mid) + upper) /
+         2;
+}
+
+std::pair<double, double> median_mad(const std::vector<double> &values) {
+  const double center = median(values);
+  std::vector<double> deviations;
+  deviations.reserve(values.size());
+  for (const double value : values) {
+    deviations.push_back(std::abs(value - center));
+  }
+
+  return {center, 1.4826 * median(deviations)};
+}
+
 } // namespace plan_database
@@ -1,7 +1,14 @@
 #ifndef UTILITY_H
 #define UTILITY_H
 
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
 #include <string>
+#include <utility>
+#include <vector>
 
 namespace plan_database {
 
@@ -22,6 +29,18 @@ namespace plan_database {
 
 int get_mkt_id(const std::string &industry);
 std::string get_industry_name(const int mkt_id);
+std::string get_industry_code(const int mkt_id);
+
+// 64-bit FNV-1a hash of size bytes, continuing from hash
+const uint64_t FNV_OFFSET = 14695981039346656037ULL;
+uint64_t fnv1a(const void *data, const size_t size,
+               const uint64_t hash = FNV_OFFSET);
+uint64_t fnv1a(const std::string &str, const uint64_t hash = FNV_OFFSET);
+
+// Median, and the median absolute deviation scaled by 1.4826 to be consistent
+// with the standard deviation of normal data (values must not be empty)
+double median(std::vector<double> values);
+std::pair<double, double> median_mad(const std::vector<double> &values);
 
 } // namespace plan_database
 
@@ -0,0 +1,152 @@
+#include "validation.h"
+
+namespace plan_database {
+
+namespace validation {
+
+std::vector<Rule> survey_rules() {
+  std::vector<Rule> rules;
+  const std::string when[3] = {"last year", "this year", "next year"};
+
+  for (int k = 0; k < 3; k++) {
+    rules.push_back({Rule::SUM, 12 + k, {6 + k, 9 + k},
+                     "total sales " + when[k]});
+    rules.push_back({Rule::SUM, 35 + k, {29 + k, 32 + k},
+                     "total gross investments " + when[k]});
+  }
+
+  // Last year's and this year's values (1-indexed last year's variables, see
+  // prepare_interpolation_input step 3)
+  for (const int hist : {1, 4, 7, 60, 10, 13, 16, 19, 22, 25, 63, 28, 30, 33,
+                         36}) {
+    rules.push_back({Rule::LAG, hist - 1, {hist},
+                     "X" + std::to_string(hist) + " = previous X" +
+                         std::to_string(hist + 1)});
+  }
+
+  return rules;
+}
+
+std::vector<Violation> check_rules(const PlanColumns &columns,
+                                   const std::vector<Rule> &rules,
+                                   const double abs_tolerance,
+                                   const double rel_tolerance) {
+  std::vector<Violation> violations;
+  const int n = columns.size();
+  std::vector<double> expected(n);
+
+  for (int r = 0; r < rules.size(); r++) {
+    const Rule &rule = rules[r];
+    if (rule.target >= columns.n_vars() ||
+        *std::max_element(rule.terms.begin(), rule.terms.end()) >=
+            columns.n_vars())
+      continue;
+    const std::vector<double> &target = columns.vars[rule.target];
+
+    // Expected values of the column (NA if any term is NA)
+    if (rule.type == Rule::SUM) {
+      std::fill(expected.begin(), expected.end(), 0.0);
+      for (const int term : rule.terms) {
+        const std::vector<double> &values = columns.vars[term];
+        for (int row = 0; row < n; row++) {
+          expected[row] = values[row] == EMPTY_NUM || expected[row] == EMPTY_NUM
+                              ? EMPTY_NUM
+                              : expected[row] + values[row];
+        }
+      }
+    } else {
+      const std::vector<double> &values = columns.vars[rule.terms[0]];
+      for (int row = 0; row < n; row++) {
+        const int prev = columns.prev_rows[row];
+        expected[row] = prev < 0 ? EMPTY_NUM : values[prev];
+      }
+    }
+
+    for (int row = 0; row < n; row++) {
+      if (target[row] == EMPTY_NUM || expected[row] == EMPTY_NUM)
+        continue;
+
+      const double tolerance =
+          std::max(abs_tolerance, rel_tolerance * std::abs(expected[row]));
+      if (std::abs(target[row] - expected[row]) > tolerance)
+        violations.push_back({row, r, target[row], expected[row]});
+    }
+  }
+
+  return violations;
+}
+
+std::vector<Outlier> find_outliers(const PlanColumns &columns,
+                                   const std::vector<int> &var_idxs,
+                                   const double z_threshold) {
+  std::vector<Outlier> outliers;
+
+  // Rows per year
+  std::map<int, std::vector<int>> year_rows;
+  for (int row = 0; row < columns.size(); row++) {
+    year_rows[columns.years[row]].push_back(row);
+  }
+
+  std::vector<double> logs;
+  std::vector<int> rows;
+  for (const int var : var_idxs) {
+    const std::vector<double> &values = columns.vars[var];
+
+    for (const auto &[year, year_row_idxs] : year_rows) {
+      logs.clear();
+      rows.clear();
+      for (const int row : year_row_idxs) {
+        if (values[row] != EMPTY_NUM && values[row] > 0) {
+          logs.push_back(std::log(values[row]));
+          rows.push_back(row);
+        }
+      }
+      if (logs.size() < 3)
+        continue;
+
+      const auto [center, scale] = median_mad(logs);
+      if (scale <= 0)
+        continue;
+
+      for (int i = 0; i < logs.size(); i++) {
+        const double z = (logs[i] - center) / scale;
+        if (std::abs(z) > z_threshold)
+          outliers.push_back({rows[i], var, values[rows[i]], z});
+      }
+    }
+  }
+
+  return outliers;
+}
+
+void write_report(const std::string &path, const PlanColumns &columns,
+                  const std::vector<Rule> &rules,
+                  const std::vector<Violation> &violations,
+                  const std::vector<Outlier> &outliers) {
+  std::vector<std::vector<std::string>> rows;
+
+  for (const Violation &v : violations) {
+    const Rule &rule = rules[v.rule_idx];
+    rows.push_back({std::to_string(columns.ids[v.row]),
+                    std::to_string(columns.years[v.row]),
+                    rule.type == Rule::SUM ? "identity" : "lag", rule.name,
+                    "X" + std::to_string(rule.target + 1),
+                    csv::dtostr(v.value), csv::dtostr(v.expected),
+                    csv::dtostr(v.value - v.expected)});
+  }
+  for (const Outlier &o : outliers) {
+    rows.push_back({std::to_string(columns.ids[o.row]),
+                    std::to_string(columns.years[o.row]), "outlier",
+                    "robust z " + csv::dtostr(o.robust_z),
+                    "X" + std::to_string(o.var_idx + 1), csv::dtostr(o.value),
+                    EMPTY, EMPTY});
+  }
+
+  csv::write(path, rows, ',',
+             {"id", "year", "check", "rule", "variable", "value", "expected",
+              "difference"});
+}
+
+} // namespace validation
+
+} // namespace plan_database
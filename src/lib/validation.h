@@ -0,0 +1,62 @@
+#ifndef VALIDATION_H
+#define VALIDATION_H
+
+#include "csv.h"
+#include "plan_columns.h"
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace plan_database {
+
+namespace validation {
+
+// SUM: target equals the sum of terms (all non-NA). LAG: target (last year's
+// value) equals terms[0] (this year's value) of the division's previous year.
+// Variables are 0-indexed.
+struct Rule {
+  enum Type { SUM, LAG };
+  Type type;
+  int target;
+  std::vector<int> terms;
+  std::string name;
+};
+
+// Identities of the planning survey: total sales (X13-X15) are sales abroad
+// plus domestic sales, total gross investments (X36-X38) are building plus
+// machinery, and last year's values equal the previous wave's this-year values
+std::vector<Rule> survey_rules();
+
+// Rows are rows of PlanColumns
+struct Violation {
+  int row, rule_idx;
+  double value, expected;
+};
+struct Outlier {
+  int row, var_idx;
+  double value, robust_z;
+};
+
+// Violations beyond max(abs_tolerance, rel_tolerance * |expected|)
+std::vector<Violation> check_rules(const PlanColumns &columns,
+                                   const std::vector<Rule> &rules,
+                                   const double abs_tolerance,
+                                   const double rel_tolerance);
+// Positive values whose log is more than z_threshold robust z-scores (median,
+// MAD) from the year's cross-section of the variable
+std::vector<Outlier> find_outliers(const PlanColumns &columns,
+                                   const std::vector<int> &var_idxs,
+                                   const double z_threshold);
+
+void write_report(const std::string &path, const PlanColumns &columns,
+                  const std::vector<Rule> &rules,
+                  const std::vector<Violation> &violations,
+                  const std::vector<Outlier> &outliers);
+
+} // namespace validation
+
+} // namespace plan_database
+
+#endif // VALIDATION_H
@@ -0,0 +1,479 @@
+#include "vector_chart.h"
+
+namespace plan_database {
+
+static std::string to_str(const double value) {
+  char buffer[32];
+  std::snprintf(buffer, sizeof(buffer), "%.2f", value);
+  return buffer;
+}
+
+static int count_chars(const std::string &s) {
+  int n = 0;
+  for (const unsigned char c : s) {
+    if ((c & 0xC0) != 0x80) // Skip UTF-8 continuation bytes
+      n++;
+  }
+  return n;
+}
+
+static double text_width(const std::string &s, const double size) {
+  return 0.6 * size * count_chars(s); // Courier advance: 0.6 em
+}
+
+//
+// SVG
+//
+
+class SvgCanvas : public VectorChart::Canvas {
+public:
+  SvgCanvas(const int width, const int height, const std::string &_id)
+      : id(_id) {
+    out << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+        << "<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"" << width
+        << "\" height=\"" << height << "\" viewBox=\"0 0 " << width << " "
+        << height << "\" font-family=\"Courier New, Courier, monospace\">\n"
+        << "<rect width=\"100%\" height=\"100%\" fill=\"white\"/>\n";
+  }
+
+  void polyline(const std::vector<double> &x, const std::vector<double> &y,
+                const int style_idx, const bool is_marked,
+                const double width) override {
+    if (x.empty())
+      return;
+
+    out << "<path fill=\"none\" stroke=\""
+        << (is_marked ? "rgb(220,50,50)" : "black") << "\" stroke-width=\""
+        << to_str(width) << "\" stroke-linejoin=\"miter\"";
+    const std::vector<double> &dashes =
+        VectorChart::dash_patterns[style_idx];
+    if (!dashes.empty()) {
+      out << " stroke-dasharray=\"";
+      for (size_t i = 0; i < dashes.size(); i++) {
+        out << (i ? "," : "") << to_str(dashes[i] * width);
+      }
+      out << "\"";
+    }
+
+    out << " d=\"M" << to_str(x[0]) << " " << to_str(y[0]);
+    for (size_t i = 1; i < x.size(); i++) {
+      out << "L" << to_str(x[i]) << " " << to_str(y[i]);
+    }
+    out << "\"/>\n";
+  }
+
+  void text(const double x, const double y, const std::string &s,
+            const double size, const double anchor,
+            const bool vertical) override {
+    const char *text_anchor =
+        anchor <= 0 ? "start" : (anchor >= 1 ? "end" : "middle");
+    out << "<text x=\"" << to_str(x) << "\" y=\"" << to_str(y)
+        << "\" font-size=\"" << to_str(size) << "\" text-anchor=\""
+        << text_anchor << "\"";
+    if (vertical)
+      out << " transform=\"rotate(-90 " << to_str(x) << " " << to_str(y)
+          << ")\"";
+    out << ">" << escape(s) << "</text>\n";
+  }
+
+  void legend_symbol(const double x, const double y, const int style_idx,
+                     const double /*width*/) override {
+    text(x, y, VectorChart::line_style_legends[style_idx],
+         VectorChart::legend_size, 0, false);
+  }
+
+  void clip(const double x, const double y, const double w,
+            const double h) override {
+    const std::string clip_id = id + "_clip" + std::to_string(n_clips++);
+    out << "<clipPath id=\"" << clip_id << "\"><rect x=\"" << to_str(x)
+        << "\" y=\"" << to_str(y) << "\" width=\"" << to_str(w)
+        << "\" height=\"" << to_str(h) << "\"/></clipPath>\n"
+        << "<g clip-path=\"url(#" << clip_id << ")\">\n";
+  }
+
+  void unclip() override { out << "</g>\n"; }
+
+  std::string finish() override {
+    out << "</svg>\n";
+    return out.str();
+  }
+
+private:
+  std::ostringstream out;
+  std::string id;
+  int n_clips = 0;
+
+  static std::string escape(const std::string &s) {
+    std::string escaped;
+    for (const char c : s) {
+      if (c == '&')
+        escaped += "&amp;";
+      else if (c == '<')
+        escaped += "&lt;";
+      else if (c == '>')
+        escaped += "&gt;";
+      else
+        escaped += c;
+    }
+    return escaped;
+  }
+};
+
+//
+// PDF
+//
+
+class PdfCanvas : public VectorChart::Canvas {
+public:
+  PdfCanvas(const int _width, const int _height)
+      : width(_width), height(_height) {
+    // y axis pointing down, like the SVG canvas
+    out << "1 0 0 -1 0 " << height << " cm\n0 j\n";
+  }
+
+  void polyline(const std::vector<double> &x, const std::vector<double> &y,
+                const int style_idx, const bool is_marked,
+                const double line_width) override {
+    if (x.empty())
+      return;
+
+    out << (is_marked ? "0.863 0.196 0.196" : "0 0 0") << " RG "
+        << to_str(line_width) << " w [";
+    for (const double dash : VectorChart::dash_patterns[style_idx]) {
+      out << to_str(dash * line_width) << " ";
+    }
+    out << "] 0 d\n";
+
+    out << to_str(x[0]) << " " << to_str(y[0]) << " m\n";
+    for (size_t i = 1; i < x.size(); i++) {
+      out << to_str(x[i]) << " " << to_str(y[i]) << " l\n";
+    }
+    out << "S\n";
+  }
+
+  void text(const double x, const double y, const std::string &s,
+            const double size, const double anchor,
+            const bool vertical) override {
+    // Shift along the writing direction to the anchor, glyphs kept upright
+    const double shift = anchor * text_width(s, size);
+    out << "0 0 0 rg BT /F1 " << to_str(size) << " Tf ";
+    if (vertical)
+      out << "0 -1 -1 0 " << to_str(x) << " " << to_str(y + shift) << " Tm ";
+    else
+      out << "1 0 0 -1 " << to_str(x - shift) << " " << to_str(y) << " Tm ";
+    out << "(" << escape(s) << ") Tj ET\n";
+  }
+
+  void legend_symbol(const double x, const double y, const int style_idx,
+                     const double symbol_width) override {
+    // The standard PDF fonts have no box-drawing glyphs: draw the line
+    const double mid = y - 0.3 * VectorChart::legend_size;
+    polyline({x, x + symbol_width}, {mid, mid}, style_idx, false,
+             VectorChart::line_width);
+  }
+
+  void clip(const double x, const double y, const double w,
+            const double h) override {
+    out << "q " << to_str(x) << " " << to_str(y) << " " << to_str(w) << " "
+        << to_str(h) << " re W n\n";
+  }
+
+  void unclip() override { out << "Q\n"; }
+
+  std::string finish() override {
+    const std::string content = out.str();
+    const std::vector<std::string> objects = {
+        "<< /Type /Catalog /Pages 2 0 R >>",
+        "<< /Type /Pages /Kids [3 0 R] /Count 1 >>",
+        "<< /Type /Page /Parent 2 0 R /MediaBox [0 0 " +
+            std::to_string(width) + " " + std::to_string(height) +
+            "] /Resources << /Font << /F1 4 0 R >> >> /Contents 5 0 R >>",
+        "<< /Type /Font /Subtype /Type1 /BaseFont /Courier /Encoding "
+        "/WinAnsiEncoding >>",
+        "<< /Length " + std::to_string(content.size()) + " >>\nstream\n" +
+            content + "endstream"};
+
+    std::string pdf = "%PDF-1.4\n";
+    std::vector<size_t> offsets;
+    for (size_t i = 0; i < objects.size(); i++) {
+      offsets.push_back(pdf.size());
+      pdf += std::to_string(i + 1) + " 0 obj\n" + objects[i] + "\nendobj\n";
+    }
+
+    const size_t xref_offset = pdf.size();
+    pdf += "xref\n0 " + std::to_string(objects.size() + 1) +
+           "\n0000000000 65535 f \n";
+    for (const size_t offset : offsets) {
+      char entry[32];
+      std::snprintf(entry, sizeof(entry), "%010zu 00000 n \n", offset);
+      pdf += entry;
+    }
+    pdf += "trailer\n<< /Size " + std::to_string(objects.size() + 1) +
+           " /Root 1 0 R >>\nstartxref\n" + std::to_string(xref_offset) +
+           "\n%%EOF\n";
+
+    return pdf;
+  }
+
+private:
+  std::ostringstream out;
+  int width, height;
+
+  // UTF-8 to WinAnsi (Latin-1 range), PDF string escapes
+  static std::string escape(const std::string &s) {
+    std::string escaped;
+    for (size_t i = 0; i < s.size(); i++) {
+      unsigned int c = (unsigned char)s[i];
+      if (c >= 0x80) {
+        if ((c & 0xE0) == 0xC0 && i + 1 < s.size()) {
+          c = ((c & 0x1F) << 6) | ((unsigned char)s[++i] & 0x3F);
+          if (c > 0xFF)
+            c = '?'; // Outside Latin-1
+        } else {
+          while (i + 1 < s.size() && ((unsigned char)s[i + 1] & 0xC0) == 0x80)
+            i++;
+          c = '?';
+        }
+      }
+
+      if (c == '(' || c == ')' || c == '\\') {
+        escaped += '\\';
+        escaped += (char)c;
+      } else if (c >= 0x80) {
+        char octal[8];
+        std::snprintf(octal, sizeof(octal), "\\%03o", c & 0xFF);
+        escaped += octal;
+      } else {
+        escaped += (char)c;
+      }
+    }
+    return escaped;
+  }
+};
+
+//
+// Chart
+//
+
+VectorChart::VectorChart(const std::string &_title,
+                         const std::string &_x_label,
+                         const std::string &_y_label)
+    : title(_title), x_label(_x_label), y_label(_y_label) {}
+
+int VectorChart::next_style(const int style_id) {
+  int style_idx = style_id == NA ? style_count++ : style_id;
+  if (style_idx >= N_STYLES)
+    throw std::runtime_error("ERROR: style_idx > N_STYLES. Too many series "
+                             "without set styles.");
+  return style_idx;
+}
+
+void VectorChart::add_line(const std::vector<double> &x,
+                           const std::vector<double> &y,
+                           const std::string &name, const int style_id) {
+  const int style_idx = next_style(style_id);
+  paths.push_back({x, y, style_idx, false});
+  legend.push_back(std::make_pair(name, style_idx));
+}
+
+void VectorChart::add_salter_curve(const SalterCurve &curve,
+                                   const std::string &name, const int style_id,
+                                   const bool beam_mark) {
+  const int style_idx = next_style(style_id);
+  legend.push_back(std::make_pair(name, style_idx));
+  x_range = {0, 100};
+  n_x_ticks = 11;
+
+  // One path per run of marked status, connections drawn unmarked
+  Path *current = nullptr;
+  for (size_t i = 0; i < curve.size(); i++) {
+    const bool is_marked = curve.marked[i];
+    const double cum = curve.x_low[i];
+
+    if (current == nullptr || current->is_marked != is_marked) {
+      const double previous_y = i > 0 ? curve.y[i - 1] : curve.y[i];
+      if (current != nullptr && is_marked) {
+        current->x.push_back(cum);
+        current->y.push_back(curve.y[i]);
+      }
+
+      paths.push_back({{}, {}, style_idx, is_marked});
+      current = &paths.back();
+
+      if (i > 0 && !is_marked) {
+        current->x.push_back(cum);
+        current->y.push_back(previous_y);
+      }
+      if (beam_mark && is_marked) {
+        current->x.insert(current->x.end(), {cum, cum});
+        current->y.insert(current->y.end(), {curve.y[i], 0});
+      }
+    }
+
+    current->x.insert(current->x.end(), {curve.x_low[i], curve.x_high[i]});
+    current->y.insert(current->y.end(), {curve.y[i], curve.y[i]});
+  }
+}
+
+std::pair<double, double>
+VectorChart::get_range(const std::pair<double, double> range,
+                       const bool is_x) const {
+  double low = range.first, high = range.second;
+  if (low != NA && high != NA)
+    return range;
+
+  double min_val = 1e9, max_val = -1e9;
+  for (const Path &path : paths) {
+    for (const double value : is_x ? path.x : path.y) {
+      min_val = std::min(value, min_val);
+      max_val = std::max(value, max_val);
+    }
+  }
+
+  // Round outwards to the magnitude of the maximum, as Graph
+  double magnitude = std::pow(10, std::floor(std::log10(max_val)));
+  low = low == NA ? std::floor(min_val / magnitude) * magnitude : low;
+  high = high == NA ? std::ceil(max_val / magnitude) * magnitude : high;
+  return std::make_pair(low, high);
+}
+
+void VectorChart::draw(Canvas &canvas, const int width,
+                       const int height) const {
+  const std::pair<double, double> xr = get_range(x_range, true);
+  const std::pair<double, double> yr = get_range(y_range, false);
+
+  auto format = [](const std::string &f, const double value) {
+    char buffer[64];
+    std::snprintf(buffer, sizeof(buffer), f.c_str(), value);
+    return std::string(buffer);
+  };
+
+  std::vector<std::string> x_ticks, y_ticks;
+  size_t y_tick_chars = 0;
+  for (int i = 0; i < n_x_ticks; i++) {
+    x_ticks.push_back(format(
+        x_format, xr.first + i * (xr.second - xr.first) / (n_x_ticks - 1)));
+  }
+  for (int i = 0; i < n_y_ticks; i++) {
+    y_ticks.push_back(format(
+        y_format, yr.first + i * (yr.second - yr.first) / (n_y_ticks - 1)));
+    y_tick_chars = std::max(y_tick_chars, y_ticks.back().size());
+  }
+
+  // Legend rows (entries without a name are hidden)
+  const double legend_gap = 2 * legend_size;
+  std::vector<std::vector<std::pair<std::string, int>>> rows(1);
+  double row_width = 0;
+  for (const auto &[name, style_idx] : legend) {
+    if (name.empty())
+      continue;
+
+    const double w =
+        text_width(line_style_legends[style_idx] + "  " + name, legend_size);
+    if (!rows.back().empty() && row_width + w > width - 40) {
+      rows.emplace_back();
+      row_width = 0;
+    }
+    rows.back().push_back(std::make_pair(name, style_idx));
+    row_width += w + legend_gap;
+  }
+
+  // Layout
+  const double legend_height = rows.size() * 1.6 * legend_size;
+  const double top = title.empty() ? 20 : 2 * title_size;
+  const double bottom = 2 * label_size + 2 * axis_size + legend_height + 10;
+  const double left = 20 + 1.6 * axis_size + 0.6 * label_size * y_tick_chars;
+  const double right = 20 + 0.3 * label_size * x_ticks.back().size();
+  const double plot_w = width - left - right, plot_h = height - top - bottom;
+
+  auto to_x = [&](const double x) {
+    return left + (x - xr.first) / (xr.second - xr.first) * plot_w;
+  };
+  auto to_y = [&](const double y) {
+    return top + plot_h - (y - yr.first) / (yr.second - yr.first) * plot_h;
+  };
+
+  // Title
+  if (!title.empty())
+    canvas.text(width / 2.0, 1.3 * title_size, title, title_size, 0.5);
+
+  // Series
+  canvas.clip(left, top, plot_w, plot_h);
+  for (const Path &path : paths) {
+    std::vector<double> px(path.x.size()), py(path.y.size());
+    for (size_t i = 0; i < px.size(); i++) {
+      px[i] = to_x(path.x[i]);
+      py[i] = to_y(path.y[i]);
+    }
+    canvas.polyline(px, py, path.style_idx, path.is_marked, line_width);
+  }
+  canvas.unclip();
+
+  // Axes and ticks
+  canvas.polyline({left, left, left + plot_w},
+                  {top, top + plot_h, top + plot_h}, 0, false, 1);
+  for (int i = 0; i < n_x_ticks; i++) {
+    const double x = left + i * plot_w / (n_x_ticks - 1);
+    canvas.polyline({x, x}, {top + plot_h, top + plot_h + 6}, 0, false, 1);
+    canvas.text(x, top + plot_h + 6 + label_size, x_ticks[i], label_size, 0.5);
+  }
+  for (int i = 0; i < n_y_ticks; i++) {
+    const double y = top + plot_h - i * plot_h / (n_y_ticks - 1);
+    canvas.polyline({left - 6, left}, {y, y}, 0, false, 1);
+    canvas.text(left - 10, y + 0.35 * label_size, y_ticks[i], label_size, 1);
+  }
+
+  // Axis titles
+  canvas.text(left + plot_w / 2, top + plot_h + 2 * label_size + axis_size,
+              x_label, axis_size, 0.5);
+  canvas.text(20 + axis_size, top + plot_h / 2, y_label, axis_size, 0.5, true);
+
+  // Legend
+  double y = height - legend_height + legend_size;
+  for (const auto &row : rows) {
+    double w = -legend_gap;
+    for (const auto &[name, style_idx] : row) {
+      w += text_width(line_style_legends[style_idx] + "  " + name,
+                      legend_size) +
+           legend_gap;
+    }
+
+    double x = (width - w) / 2;
+    for (const auto &[name, style_idx] : row) {
+      const double symbol_w =
+          text_width(line_style_legends[style_idx] + "  ", legend_size);
+      canvas.legend_symbol(x, y, style_idx,
+                           text_width(line_style_legends[style_idx],
+                                      legend_size));
+      canvas.text(x + symbol_w, y, name, legend_size, 0);
+      x += symbol_w + text_width(name, legend_size) + legend_gap;
+    }
+    y += 1.6 * legend_size;
+  }
+}
+
+std::string VectorChart::to_string(const int width, const int height,
+                                   const Format format) const {
+  if (format == SVG) {
+    SvgCanvas canvas(width, height, id);
+    draw(canvas, width, height);
+    return canvas.finish();
+  }
+
+  PdfCanvas canvas(width, height);
+  draw(canvas, width, height);
+  return canvas.finish();
+}
+
+void VectorChart::write(const std::string &path, const int width,
+                        const int height, const Format format) const {
+  const std::string file_name = path + (format == SVG ? ".svg" : ".pdf");
+  std::ofstream file(file_name, std::ios::binary);
+  if (!file.is_open())
+    throw std::runtime_error("ERROR: Could not open file " + file_name);
+  file << to_string(width, height, format);
+
+  std::cout << "Saved chart: " << file_name << std::endl;
+}
+
+} // namespace plan_database
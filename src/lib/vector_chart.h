@@ -0,0 +1,105 @@
+#ifndef VECTOR_CHART_H
+#define VECTOR_CHART_H
+
+#include "salter.h"
+#include "utility.h"
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#define N_STYLES 5
+
+namespace plan_database {
+
+// Black-and-white line and salter charts written directly as SVG or PDF from
+// the point arrays, without Qt. Layout, fonts and line styles follow Graph.
+class VectorChart {
+public:
+  enum Format { SVG, PDF };
+
+  // Polyline in chart values
+  struct Path {
+    std::vector<double> x, y;
+    int style_idx;
+    bool is_marked = false;
+  };
+
+  std::string title, x_label, y_label;
+  std::string x_format = "%.0f", y_format = "%.2f";
+  std::pair<double, double> x_range = {NA, NA}, y_range = {NA, NA};
+  int n_x_ticks = 5, n_y_ticks = 5;
+  std::string id = "chart"; // Prefix of SVG element ids
+
+  // Configuration
+  //
+  //
+  // Dash patterns in line widths (Solid, Dash, DashDot, DashDotDot, Dot)
+  static inline const std::vector<double> dash_patterns[N_STYLES] = {
+      {}, {4, 2}, {4, 2, 1, 2}, {4, 2, 1, 2, 1, 2}, {1, 2}};
+  static inline std::string line_style_legends[N_STYLES] = {
+      "─────",   // SolidLine
+      "─ ─ ─",   // DashLine
+      "─·─·─",   // DashDotLine
+      "─··─··─", // DashDotDotLine
+      "· · ·",   // DotLine
+  };
+  constexpr static double line_width = 2;
+  constexpr static double title_size = 37, axis_size = 24, label_size = 19,
+                          legend_size = 16; // Font sizes (px)
+  //
+  //
+  // END Configuration
+
+  VectorChart(const std::string &_title, const std::string &_x_label,
+              const std::string &_y_label);
+
+  void add_line(const std::vector<double> &x, const std::vector<double> &y,
+                const std::string &name = "", const int style_id = NA);
+  // Step curve over 0-100 % of production, marked steps drawn in red
+  void add_salter_curve(const SalterCurve &curve, const std::string &name = "",
+                        const int style_id = NA, const bool beam_mark = false);
+
+  // Writes path + ".svg" or ".pdf"
+  void write(const std::string &path, const int width, const int height,
+             const Format format = SVG) const;
+  std::string to_string(const int width, const int height,
+                        const Format format = SVG) const;
+
+  // Drawing primitives of one output format (coordinates in px, y down)
+  class Canvas {
+  public:
+    virtual ~Canvas() = default;
+    virtual void polyline(const std::vector<double> &x,
+                          const std::vector<double> &y, const int style_idx,
+                          const bool is_marked, const double width) = 0;
+    virtual void text(const double x, const double y, const std::string &s,
+                      const double size, const double anchor,
+                      const bool vertical = false) = 0; // anchor: 0 to 1
+    virtual void legend_symbol(const double x, const double y,
+                               const int style_idx, const double width) = 0;
+    virtual void clip(const double x, const double y, const double w,
+                      const double h) = 0;
+    virtual void unclip() = 0;
+    virtual std::string finish() = 0;
+  };
+
+private:
+  std::vector<Path> paths;
+  std::vector<std::pair<std::string, int>> legend; // name and style
+  int style_count = 0;
+
+  int next_style(const int style_id);
+  std::pair<double, double> get_range(const std::pair<double, double> range,
+                                      const bool is_x) const;
+  void draw(Canvas &canvas, const int width, const int height) const;
+};
+
+} // namespace plan_database
+
+#endif // VECTOR_CHART_H
@@ -26,6 +26,32 @@ void print_key_beautiful(Database &db) {
   }
 }
 
+void print_duplicate_names(Database &db) {
+  // Latest name of each division
+  std::vector<std::pair<int, std::string>> names;
+  std::vector<similarity::Signature> sigs;
+  for (const Division &div : db.plandata.divs) {
+    for (int i = div.obs.size() - 1; i >= 0; i--) {
+      if (!csv::empty(div.obs[i].name)) {
+        names.push_back({div.id, div.obs[i].name});
+        sigs.push_back(similarity::signature(div.obs[i].name));
+        break;
+      }
+    }
+  }
+
+  std::cout << "id;name;duplicate_id;duplicate_name;similarity" << std::endl;
+  for (int i = 0; i < names.size(); i++) {
+    for (int j = i + 1; j < names.size(); j++) {
+      const double sim = similarity::jaccard(sigs[i], sigs[j]);
+      if (sim >= DUPLICATE_SIMILARITY)
+        std::cout << names[i].first << ";" << names[i].second << ";"
+                  << names[j].first << ";" << names[j].second << ";" << sim
+                  << std::endl;
+    }
+  }
+}
+
 } // namespace plan_database
 
 int main() {
@@ -34,6 +60,7 @@ int main() {
 
   print_key_csv(db);
   // print_key_beautiful(db);
+  // print_duplicate_names(db);
 
   return 0;
 }
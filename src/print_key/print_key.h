@@ -1,8 +1,15 @@
 #include "../lib/db.h"
+#include "../lib/similarity.h"
+
+// Parameters
+#define DUPLICATE_SIMILARITY                                                   \
+  0.8 // Minimum similarity (Jaccard of 3-grams) of two divisions' latest names
+      // to print them as possible duplicates (print_duplicate_names())
 
 namespace plan_database {
 
 void print_key(Database &db);
 void print_key_beautiful(Database &db);
+void print_duplicate_names(Database &db);
 
 } // namespace plan_database
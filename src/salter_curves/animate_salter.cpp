@@ -0,0 +1,141 @@
+//
+//
+// NOTE:
+// Headless year-by-year salter curves of VARIANT, FIRST_YEAR-LAST_YEAR, with
+// fixed axes. Every frame is written as a numbered SVG file, and all frames
+// as one animated SVG (SMIL, plays in browsers).
+//
+//
+
+#include "animate_salter.h"
+
+namespace plan_database {
+
+std::vector<Frame> to_frames(const FirmPanel &panel,
+                             DerivedVariables &derived) {
+  const std::vector<double> &x = derived.evaluate(panel, "value_added");
+  const std::vector<double> &y = derived.evaluate(panel, VARIANT);
+
+  // Each year starts from the previous year's order of the same firms, so
+  // sorting is close to linear when ranks change little
+  std::vector<Frame> frames;
+  for (int year = FIRST_YEAR; year <= LAST_YEAR; year++) {
+    const SalterCurve *previous =
+        frames.empty() ? nullptr : &frames.back().curve;
+    SalterCurve curve =
+        SalterCurve::from_panel(panel, x, y, year, NO_MKT, previous);
+    if (curve.size() == 0) {
+      std::cout << "WARNING: No firms in " << year << ", frame skipped"
+                << std::endl;
+      continue;
+    }
+
+    frames.push_back({year, std::move(curve), ""});
+  }
+
+  return frames;
+}
+
+std::pair<double, double> get_fixed_y_range(const std::vector<Frame> &frames) {
+  double max_val = 0.0;
+  for (const Frame &frame : frames) {
+    if (frame.curve.size())
+      max_val = std::max(max_val, frame.curve.y.front()); // Sorted descending
+  }
+  if (max_val <= 0)
+    return std::make_pair(0.0, 1.0);
+
+  // Rounded up to the magnitude of the maximum, as Graph
+  double magnitude = std::pow(10, std::floor(std::log10(max_val)));
+  return std::make_pair(0.0, std::ceil(max_val / magnitude) * magnitude);
+}
+
+void render_frames(std::vector<Frame> &frames,
+                   const std::pair<double, double> y_range) {
+  ThreadPool pool(N_THREADS);
+  pool.parallel_for((int)frames.size(), [&frames, y_range](int i) {
+    VectorChart chart(std::to_string(frames[i].year), "% of production",
+                      Y_LABEL);
+    chart.y_range = y_range;
+    chart.id = "frame" + std::to_string(i);
+    chart.add_salter_curve(frames[i].curve);
+    frames[i].svg = chart.to_string(WIDTH, HEIGHT, VectorChart::SVG);
+  });
+}
+
+void write_frames(const std::vector<Frame> &frames, const std::string &path) {
+  for (int i = 0; i < frames.size(); i++) {
+    char number[12];
+    std::snprintf(number, sizeof(number), "%02d", i);
+    const std::string file_name = path + "_" + number + "_" +
+                                  std::to_string(frames[i].year) + ".svg";
+
+    std::ofstream file(file_name, std::ios::binary);
+    if (!file.is_open())
+      throw std::runtime_error("ERROR: Could not open file " + file_name);
+    file << frames[i].svg;
+  }
+
+  std::cout << "Saved SVG frames: " << path << "_*.svg (" << frames.size()
+            << " frames)" << std::endl;
+}
+
+void write_animation(const std::vector<Frame> &frames,
+                     const std::string &path) {
+  std::ofstream file(path, std::ios::binary);
+  if (!file.is_open())
+    throw std::runtime_error("ERROR: Could not open file " + path);
+
+  const int n = (int)frames.size();
+  file << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+       << "<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"" << WIDTH
+       << "\" height=\"" << HEIGHT << "\" viewBox=\"0 0 " << WIDTH << " "
+       << HEIGHT << "\">\n";
+
+  // Frame i is displayed during [i, i + 1) / n of every cycle
+  for (int i = 0; i < n; i++) {
+    const std::string begin = csv::dtostr((double)i / n);
+    const std::string end = csv::dtostr((double)(i + 1) / n);
+    file << "<g display=\"none\">\n<animate attributeName=\"display\" "
+         << (i == 0 ? "values=\"inline;none\" keyTimes=\"0;" + end
+                    : "values=\"none;inline;none\" keyTimes=\"0;" + begin +
+                          ";" + end)
+         << "\" calcMode=\"discrete\" dur=\"" << csv::dtostr(n * FRAME_SECONDS)
+         << "s\" repeatCount=\"indefinite\"/>\n";
+
+    // Frame without its XML declaration
+    const std::string &svg = frames[i].svg;
+    file << svg.substr(svg.find("<svg")) << "</g>\n";
+  }
+  file << "</svg>\n";
+
+  std::cout << "Saved animated SVG: " << path << " (" << n << " frames)"
+            << std::endl;
+}
+
+} // namespace plan_database
+
+int main() {
+  plan_database::Database db;
+  db.plandata.parse_csv("../data/interpolated.csv", ',', true);
+  db.macrodata.parse_csv("../data/macrodatabase.csv");
+  db.plandata.filter_markets({DUR, NDUR, IMED, RAW});
+  db.macrodata.filter_markets({DUR, NDUR, IMED, RAW});
+
+  // One panel of all years, shared by every frame
+  plan_database::FirmPanel panel =
+      plan_database::FirmPanel::from_cross_sections(db.plandata,
+                                                    db.macrodata, false);
+  plan_database::DerivedVariables derived;
+
+  std::vector<plan_database::Frame> frames =
+      plan_database::to_frames(panel, derived);
+  plan_database::render_frames(frames,
+                               plan_database::get_fixed_y_range(frames));
+
+  const std::string path = std::string("salter_") + VARIANT;
+  plan_database::write_frames(frames, path);
+  plan_database::write_animation(frames, path + "_animated.svg");
+
+  return 0;
+}
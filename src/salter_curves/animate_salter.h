@@ -0,0 +1,34 @@
+#include "../lib/db.h"
+#include "../lib/derived.h"
+#include "../lib/panel.h"
+#include "../lib/pool.h"
+#include "../lib/salter.h"
+#include "../lib/vector_chart.h"
+
+// Parameters
+#define VARIANT "productivity" // Derived variable drawn (weight: value added)
+#define Y_LABEL "Value productivity per employee (MSEK)"
+#define FIRST_YEAR MIN_YEAR
+#define LAST_YEAR MAX_YEAR
+#define FRAME_SECONDS 0.5 // Display time of each frame in the animation
+#define WIDTH 1000
+#define HEIGHT 2000
+#define N_THREADS 0 // Threads rendering frames (0: all hardware threads)
+
+namespace plan_database {
+
+struct Frame {
+  int year;
+  SalterCurve curve;
+  std::string svg;
+};
+
+std::vector<Frame> to_frames(const FirmPanel &panel, DerivedVariables &derived);
+std::pair<double, double> get_fixed_y_range(const std::vector<Frame> &frames);
+void render_frames(std::vector<Frame> &frames,
+                   const std::pair<double, double> y_range);
+void write_frames(const std::vector<Frame> &frames, const std::string &path);
+void write_animation(const std::vector<Frame> &frames,
+                     const std::string &path);
+
+} // namespace plan_database
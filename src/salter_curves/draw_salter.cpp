@@ -3,427 +3,299 @@ using namespace plan_database;
 
 namespace plan_database {
 
-void draw_one_firm_develops(Database db) {
+void run_chart_jobs(std::vector<ChartJob> &jobs) {
+  // Compute every chart's series in parallel
+  ThreadPool pool(N_THREADS);
+  pool.parallel_for((int)jobs.size(), [&jobs](int i) {
+    std::ostringstream log;
+    jobs[i].series = jobs[i].compute(log);
+    jobs[i].log = log.str();
+  });
+
+  // Qt objects live on the main thread: create and export one at a time
+  for (ChartJob &job : jobs) {
+    std::cout << job.log;
+    Graph salter("", "% of production", job.y_label, job.series);
+    QChart *chart = salter.create_salter_chart(job.y_range);
+    Graph::export_chart(job.path, chart, 1000, 2000, EXPORT_FORMAT);
+  }
+}
+
+std::vector<Graph::Serie> to_one_firm_develops_series(Database db) {
   db.plandata.filter_interval(LOW, HIGH, false);
 
   std::vector<Firm> firms = Firm::to_real_firms(db.plandata, years_fewer);
   firms = Firm::filter_years(firms, years_fewer);
 
+  FirmPanel panel(firms);
+  DerivedVariables derived;
+  const std::vector<double> &x = derived.evaluate(panel, "value_added");
+  const std::vector<double> &y = derived.evaluate(panel, "productivity");
+
   std::vector<Graph::Serie> series;
   for (int year : years_fewer) {
 
-    std::vector<Graph::Point> points;
-    for (const Firm &firm : firms) {
-      for (const Firm::Observation &ob : firm.obs) {
-        if (ob.year == year) {
-          const double y = 1e-6 * (ob.sales - ob.input_cost) / ob.employees;
-          const double x = ob.sales - ob.input_cost;
-          points.push_back({x, y, firm.id == CASE_ID});
-          break;
-        }
-      }
+    SalterCurve curve = SalterCurve::from_panel(panel, x, y, year);
+    for (size_t i = 0; i < curve.size(); i++) {
+      curve.marked[i] = panel.firm_ids[curve.index[i]] == CASE_ID;
     }
 
-    Graph::Serie serie(points, std::to_string(year));
-    serie.sort_points();
+    Graph::Serie serie(curve, std::to_string(year));
     serie.beam_mark = true;
     series.push_back(serie);
   }
 
-  Graph salter("", "% of production", "Value productivity per employee (MSEK)",
-               series);
-  QChart *chart = salter.create_salter_chart();
-  Graph::export_chart("labor_productivity_distrs_one_case", chart, 1000, 2000);
+  return series;
 }
 
-void draw_productivity_distrs(Database db) {
-  std::vector<Firm> firms =
-      Firm::to_firms(db.plandata, db.macrodata, false, years);
+std::vector<Graph::Serie> to_distrs_series(const FirmPanel &panel,
+                                           DerivedVariables &derived,
+                                           const std::string &variant,
+                                           std::ostream &log) {
+  const std::vector<double> &x = derived.evaluate(panel, "value_added");
+  const std::vector<double> &y = derived.evaluate(panel, variant);
 
   std::vector<Graph::Serie> series;
   for (int year : years) {
-
-    std::vector<Graph::Point> points;
-    for (const Firm &firm : firms) {
-      for (const Firm::Observation &ob : firm.obs) {
-        if (ob.year == year) {
-          const double y = 1e-6 * (ob.sales - ob.input_cost) / ob.employees;
-          const double x = ob.sales - ob.input_cost;
-          points.push_back({x, y, firm.is_synthetic});
-          break;
-        }
-      }
-    }
-
-    Graph::Serie serie(points, std::to_string(year));
-    serie.sort_points();
+    Graph::Serie serie(SalterCurve::from_panel(panel, x, y, year),
+                       std::to_string(year));
     series.push_back(serie);
 
-    std::cout << "productivity: year: " << year
-              << " n_points: " << serie.points.size() << std::endl;
+    log << variant << ": year: " << year
+        << " n_points: " << serie.points.size() << std::endl;
   }
 
-  Graph salter("", "% of production", "Value productivity per employee (MSEK)",
-               series);
-  QChart *chart = salter.create_salter_chart({0, NA});
-  Graph::export_chart("labor_productivity_distrs_1982-1997", chart, 1000, 2000);
+  return series;
 }
 
-void draw_productivity_distrs_per_industry(Database db, const int year) {
-  std::vector<Firm> firms =
-      Firm::to_firms(db.plandata, db.macrodata, true, years);
+std::vector<Graph::Serie>
+to_distrs_series_per_industry(const FirmPanel &panel, DerivedVariables &derived,
+                              const std::string &variant, const int year) {
+  const std::vector<double> &x = derived.evaluate(panel, "value_added");
+  const std::vector<double> &y = derived.evaluate(panel, variant);
 
   std::vector<Graph::Serie> series;
   for (int mkt_id : {RAW, IMED, DUR, NDUR}) {
-    std::vector<Graph::Point> points;
-    for (const Firm &firm : firms) {
-      if (firm.mkt_id != mkt_id)
-        continue;
-
-      for (const Firm::Observation &ob : firm.obs) {
-        if (ob.year == year) {
-          const double y = 1e-6 * (ob.sales - ob.input_cost) / ob.employees;
-          const double x = ob.sales - ob.input_cost;
-          points.push_back({x, y, firm.is_synthetic});
-          break;
-        }
-      }
-    }
-
-    Graph::Serie serie(points, get_industry_name(mkt_id));
-    serie.sort_points();
-    series.push_back(serie);
+    series.push_back(
+        Graph::Serie(SalterCurve::from_panel(panel, x, y, year, mkt_id),
+                     get_industry_name(mkt_id)));
   }
 
-  Graph salter("", "% of production", "Value productivity per employee (MSEK)",
-               series);
-  QChart *chart = salter.create_salter_chart({0, NA});
-  Graph::export_chart("labor_productivity_distrs_per_industry_" +
-                          std::to_string(year),
-                      chart, 1000, 2000);
+  return series;
 }
 
-void draw_productivity_distrs_no_selection(Database db) {
+std::vector<Graph::Serie>
+to_productivity_distrs_no_selection_series(const Database &db,
+                                           std::ostream &log) {
   std::vector<Graph::Serie> series;
   for (int year : years) {
 
-    std::vector<Firm> firms =
-        Firm::to_firms(db.plandata, db.macrodata, false, {year});
-
-    std::vector<Graph::Point> points;
-    for (const Firm &firm : firms) {
-      for (const Firm::Observation &ob : firm.obs) {
-        if (ob.year == year) {
-          const double y = 1e-6 * (ob.sales - ob.input_cost) / ob.employees;
-          const double x = ob.sales - ob.input_cost;
-          points.push_back({x, y, firm.is_synthetic});
-          break;
-        }
-      }
-    }
+    // Independent cross-section per year (no selection across years)
+    FirmPanel panel(Firm::to_firms(db.plandata, db.macrodata, false, {year}));
+    DerivedVariables derived;
+    const std::vector<double> &x = derived.evaluate(panel, "value_added");
+    const std::vector<double> &y = derived.evaluate(panel, "productivity");
 
-    Graph::Serie serie(points, std::to_string(year));
-    serie.sort_points();
+    Graph::Serie serie(SalterCurve::from_panel(panel, x, y, year),
+                       std::to_string(year));
     series.push_back(serie);
 
-    std::cout << "productivity: year: " << year
-              << " n_points: " << serie.points.size() << std::endl;
+    log << "productivity: year: " << year
+        << " n_points: " << serie.points.size() << std::endl;
   }
 
-  Graph salter("", "% of production", "Value productivity per employee (MSEK)",
-               series);
-  QChart *chart = salter.create_salter_chart({0, NA});
-  Graph::export_chart("labor_productivity_distrs_no_selection_1982-1997", chart,
-                      1000, 2000);
-}
-
-void draw_productivity_distrs_no_selection_interpolated(Database db) {
-  std::vector<Graph::Serie> series;
-  for (int year : years) {
-
-    std::vector<Firm> firms =
-        Firm::to_firms(db.plandata, db.macrodata, false, {year});
-
-    std::vector<Graph::Point> points;
-    for (const Firm &firm : firms) {
-      for (const Firm::Observation &ob : firm.obs) {
-        if (ob.year == year) {
-          const double y = 1e-6 * (ob.sales - ob.input_cost) / ob.employees;
-          const double x = ob.sales - ob.input_cost;
-          points.push_back({x, y, firm.is_synthetic});
-          break;
-        }
-      }
-    }
-
-    Graph::Serie serie(points, std::to_string(year));
-    serie.sort_points();
-    series.push_back(serie);
-
-    std::cout << "productivity: year: " << year
-              << " n_points: " << serie.points.size() << std::endl;
-  }
-
-  Graph salter("", "% of production", "Value productivity per employee (MSEK)",
-               series);
-  QChart *chart = salter.create_salter_chart({0, NA});
-  Graph::export_chart(
-      "labor_productivity_distrs_no_selection_interpolated_1982-1997", chart,
-      1000, 2000);
-}
-
-void draw_wage_cost_distrs(Database db) {
-  std::vector<Firm> firms =
-      Firm::to_firms(db.plandata, db.macrodata, false, years);
-
-  std::vector<Graph::Serie> series;
-  for (int year : years) {
-
-    std::vector<Graph::Point> points;
-    for (const Firm &firm : firms) {
-      for (const Firm::Observation &ob : firm.obs) {
-        if (ob.year == year) {
-          const double y = 1e-6 * (ob.wage_sum) / ob.employees;
-          const double x = ob.sales - ob.input_cost;
-          points.push_back({x, y, firm.is_synthetic});
-          break;
-        }
-      }
-    }
-
-    Graph::Serie serie(points, std::to_string(year));
-    serie.sort_points();
-    series.push_back(serie);
-  }
-
-  Graph salter("", "% of production", "Wage cost per employee (MSEK)", series);
-  QChart *chart = salter.create_salter_chart({0, NA});
-  Graph::export_chart("wage_cost_distrs_1982-1997", chart, 1000, 2000);
-}
-
-void draw_wage_cost_distrs_per_industry(Database db, const int year) {
-  std::vector<Firm> firms =
-      Firm::to_firms(db.plandata, db.macrodata, true, years);
-
-  std::vector<Graph::Serie> series;
-  for (int mkt_id : {RAW, IMED, DUR, NDUR}) {
-    std::vector<Graph::Point> points;
-    for (const Firm &firm : firms) {
-      if (firm.mkt_id != mkt_id)
-        continue;
-
-      for (const Firm::Observation &ob : firm.obs) {
-        if (ob.year == year) {
-          const double y = 1e-6 * (ob.wage_sum) / ob.employees;
-          const double x = ob.sales - ob.input_cost;
-          points.push_back({x, y, firm.is_synthetic});
-          break;
-        }
-      }
-    }
-
-    Graph::Serie serie(points, get_industry_name(mkt_id));
-    serie.sort_points();
-    series.push_back(serie);
-  }
-
-  Graph salter("", "% of production", "Wage cost per employee (MSEK)", series);
-  QChart *chart = salter.create_salter_chart({0, NA});
-  Graph::export_chart("wage_cost_distrs_per_industry_" + std::to_string(year),
-                      chart, 1000, 2000);
+  return series;
 }
 
 std::pair<Graph::Serie, Graph::Serie>
-to_aligned_prod_wage_series(const std::vector<Firm> &firms,
+to_aligned_prod_wage_series(const FirmPanel &panel, DerivedVariables &derived,
                             const int year_idx) {
 
-  std::vector<Graph::Point> prod_points, wage_points;
-
-  for (const Firm &firm : firms) {
-    for (const Firm::Observation &ob : firm.obs) {
+  const std::vector<double> &x = derived.evaluate(panel, "value_added");
+  const std::vector<double> &prod = derived.evaluate(panel, "productivity");
+  const std::vector<double> &wage = derived.evaluate(panel, "wage_cost");
 
-      if (ob.year != years[year_idx])
-        continue;
-
-      const double prod_y = 1e-6 * (ob.sales - ob.input_cost) / ob.employees;
-      const double wage_y = 1e-6 * ob.wage_sum / ob.employees;
-      const double x = ob.sales - ob.input_cost;
-
-      prod_points.push_back(Graph::Point(x, prod_y, firm.is_synthetic));
-      wage_points.push_back(Graph::Point(x, wage_y, firm.is_synthetic));
-    }
-  }
-
-  //
-  //
-  // Sorting Logic
-  //
-  //
-
-  // Create indices and sort by productivity (descending)
-  std::vector<size_t> indices(prod_points.size());
-  std::iota(indices.begin(), indices.end(), 0);
-  std::sort(indices.begin(), indices.end(), [&prod_points](size_t i, size_t j) {
-    return prod_points[i].y >
-           prod_points[j].y; // sort by productivity descending
-  });
-
-  // Rearrange both vectors using sorted indices
-  std::vector<Graph::Point> sorted_prod_points, sorted_wage_points;
-  for (size_t idx : indices) {
-    sorted_prod_points.push_back(prod_points[idx]);
-    sorted_wage_points.push_back(wage_points[idx]);
-  }
-  prod_points = sorted_prod_points;
-  wage_points = sorted_wage_points;
-
-  //
-  //
-  //
+  // Sort by productivity (descending), wage cost follows the same order
+  SalterCurve prod_curve =
+      SalterCurve::from_panel(panel, x, prod, years[year_idx]);
+  SalterCurve wage_curve = prod_curve.aligned(wage);
 
   Graph::Serie prod_serie =
-      Graph::Serie(prod_points, std::to_string(years[year_idx]), year_idx);
-  Graph::Serie wage_serie = Graph::Serie(wage_points, "", year_idx);
+      Graph::Serie(prod_curve, std::to_string(years[year_idx]), year_idx);
+  Graph::Serie wage_serie = Graph::Serie(wage_curve, "", year_idx);
 
   return std::make_pair(prod_serie, wage_serie);
 }
 
-void draw_productivity_and_wage_cost_distrs(Database db) {
-  std::vector<Firm> firms =
-      Firm::to_firms(db.plandata, db.macrodata, false, years);
-
+std::vector<Graph::Serie>
+to_productivity_and_wage_cost_series(const FirmPanel &panel,
+                                     DerivedVariables &derived,
+                                     std::ostream &log) {
   std::vector<Graph::Serie> series;
   for (int i = 0; i < years.size(); i++) {
-    auto p = to_aligned_prod_wage_series(firms, i);
+    auto p = to_aligned_prod_wage_series(panel, derived, i);
     series.push_back(p.first);
     series.push_back(p.second);
+
+    std::vector<double> crossings = SalterSummary::find_crossings(
+        p.first.to_salter_curve(), p.second.to_salter_curve());
+    log << "productivity/wage crossings: year: " << years[i]
+        << " n_crossings: " << crossings.size() << std::endl;
   }
 
-  Graph salter("", "% of production", "Million SEK per employee", series);
-  QChart *chart = salter.create_salter_chart({0, NA});
-  Graph::export_chart("productivity_and_wage_cost_distrs_1982-1997", chart,
-                      1000, 2000);
+  return series;
 }
 
 std::pair<Graph::Serie, Graph::Serie>
-to_aligned_prod_wage_series_per_industry(const std::vector<Firm> &firms,
+to_aligned_prod_wage_series_per_industry(const FirmPanel &panel,
+                                         DerivedVariables &derived,
                                          const int year_idx, const int mkt_id) {
 
-  std::vector<Graph::Point> prod_points, wage_points;
-
-  for (const Firm &firm : firms) {
-    if (firm.mkt_id != mkt_id)
-      continue;
-
-    for (const Firm::Observation &ob : firm.obs) {
-
-      if (ob.year != years[year_idx])
-        continue;
-
-      const double prod_y = 1e-6 * (ob.sales - ob.input_cost) / ob.employees;
-      const double wage_y = 1e-6 * ob.wage_sum / ob.employees;
-      const double x = ob.sales - ob.input_cost;
-
-      prod_points.push_back(Graph::Point(x, prod_y, firm.is_synthetic));
-      wage_points.push_back(Graph::Point(x, wage_y, firm.is_synthetic));
-    }
-  }
-
-  //
-  //
-  // Sorting Logic
-  //
-  //
-
-  // Create indices and sort by productivity (descending)
-  std::vector<size_t> indices(prod_points.size());
-  std::iota(indices.begin(), indices.end(), 0);
-  std::sort(indices.begin(), indices.end(), [&prod_points](size_t i, size_t j) {
-    return prod_points[i].y >
-           prod_points[j].y; // sort by productivity descending
-  });
-
-  // Rearrange both vectors using sorted indices
-  std::vector<Graph::Point> sorted_prod_points, sorted_wage_points;
-  for (size_t idx : indices) {
-    sorted_prod_points.push_back(prod_points[idx]);
-    sorted_wage_points.push_back(wage_points[idx]);
-  }
-  prod_points = sorted_prod_points;
-  wage_points = sorted_wage_points;
+  const std::vector<double> &x = derived.evaluate(panel, "value_added");
+  const std::vector<double> &prod = derived.evaluate(panel, "productivity");
+  const std::vector<double> &wage = derived.evaluate(panel, "wage_cost");
 
-  //
-  //
-  //
+  // Sort by productivity (descending), wage cost follows the same order
+  SalterCurve prod_curve =
+      SalterCurve::from_panel(panel, x, prod, years[year_idx], mkt_id);
+  SalterCurve wage_curve = prod_curve.aligned(wage);
 
   Graph::Serie prod_serie =
-      Graph::Serie(prod_points, get_industry_name(mkt_id), mkt_id);
-  Graph::Serie wage_serie = Graph::Serie(wage_points, "", mkt_id);
+      Graph::Serie(prod_curve, get_industry_name(mkt_id), mkt_id);
+  Graph::Serie wage_serie = Graph::Serie(wage_curve, "", mkt_id);
 
   return std::make_pair(prod_serie, wage_serie);
 }
 
-void draw_productivity_and_wage_cost_distrs_per_industry(Database db,
-                                                         const int year_idx) {
-  std::vector<Firm> firms =
-      Firm::to_firms(db.plandata, db.macrodata, true, years);
-
+std::vector<Graph::Serie> to_productivity_and_wage_cost_series_per_industry(
+    const FirmPanel &panel, DerivedVariables &derived, const int year_idx) {
   std::vector<Graph::Serie> series;
   for (int mkt_id : {RAW, IMED, DUR, NDUR}) {
-    auto p = to_aligned_prod_wage_series_per_industry(firms, year_idx, mkt_id);
+    auto p = to_aligned_prod_wage_series_per_industry(panel, derived, year_idx,
+                                                      mkt_id);
     series.push_back(p.first);
     series.push_back(p.second);
   }
 
-  Graph salter("", "% of production", "Million SEK per employee", series);
-  QChart *chart = salter.create_salter_chart({0, NA});
-  Graph::export_chart("productivity_and_wage_cost_distrs_per_industry_" +
-                          std::to_string(years[year_idx]),
-                      chart, 1000, 2000);
+  return series;
 }
 
 } // namespace plan_database
 
 int main(int argc, char *argv[]) {
+  Graph::use_offscreen_platform();
   QApplication app(argc, argv);
 
   Database db_interpolated;
-
   db_interpolated.plandata.parse_csv("../data/interpolated.csv", ',', true);
   db_interpolated.macrodata.parse_csv("../data/macrodatabase.csv");
-  draw_one_firm_develops(db_interpolated);
+  const Database db_one_firm = db_interpolated;
 
   db_interpolated.plandata.filter_markets({DUR, NDUR, IMED, RAW});
   db_interpolated.macrodata.filter_markets({DUR, NDUR, IMED, RAW});
+  const Database db_interpolated_no_selection = db_interpolated;
   db_interpolated.plandata.filter_years(years);
   db_interpolated.macrodata.filter_years(years);
-  draw_productivity_distrs(db_interpolated);
-  draw_wage_cost_distrs(db_interpolated);
-  draw_productivity_and_wage_cost_distrs(db_interpolated);
-
-  // Per Industry
-  for (int year_idx = 0; year_idx < years.size(); year_idx++) {
-    draw_productivity_distrs_per_industry(db_interpolated, years[year_idx]);
-    draw_wage_cost_distrs_per_industry(db_interpolated, years[year_idx]);
-    draw_productivity_and_wage_cost_distrs_per_industry(db_interpolated,
-                                                        year_idx);
-  }
-  // END Per industry
 
   Database db;
-
   db.plandata.parse_csv("../data/plan1975-2000.csv", ';', true);
   db.macrodata.parse_csv("../data/macrodatabase.csv");
   db.plandata.filter_markets({DUR, NDUR, IMED, RAW});
   db.macrodata.filter_markets({DUR, NDUR, IMED, RAW});
-  draw_productivity_distrs_no_selection(db);
-
-  Database db_interpolated2;
-  db_interpolated2.plandata.parse_csv("../data/interpolated.csv", ',', true);
-  db_interpolated2.macrodata.parse_csv("../data/macrodatabase.csv");
-  db_interpolated2.plandata.filter_markets({DUR, NDUR, IMED, RAW});
-  db_interpolated2.macrodata.filter_markets({DUR, NDUR, IMED, RAW});
-  draw_productivity_distrs_no_selection_interpolated(db_interpolated2);
+
+  // Firm panels, built once and shared by all jobs
+  const FirmPanel panel(Firm::to_firms(
+      db_interpolated.plandata, db_interpolated.macrodata, false, years));
+  const FirmPanel panel_divided(Firm::to_firms(
+      db_interpolated.plandata, db_interpolated.macrodata, true, years));
+
+  // One DerivedVariables per panel, evaluated before the jobs run, so that no
+  // job evaluates while another reads
+  DerivedVariables derived, derived_divided;
+  for (const std::string variant :
+       {"value_added", "productivity", "wage_cost"}) {
+    derived.evaluate(panel, variant);
+    derived_divided.evaluate(panel_divided, variant);
+  }
+
+  // Jobs
+  const std::string prod_label = "Value productivity per employee (MSEK)";
+  const std::string wage_label = "Wage cost per employee (MSEK)";
+  const std::string prod_wage_label = "Million SEK per employee";
+
+  std::vector<ChartJob> jobs;
+  jobs.push_back({"labor_productivity_distrs_one_case",
+                  prod_label,
+                  {NA, NA},
+                  [&](std::ostream &log) {
+                    return to_one_firm_develops_series(db_one_firm);
+                  }});
+  jobs.push_back({"labor_productivity_distrs_1982-1997",
+                  prod_label,
+                  {0, NA},
+                  [&](std::ostream &log) {
+                    return to_distrs_series(panel, derived, "productivity",
+                                            log);
+                  }});
+  jobs.push_back({"wage_cost_distrs_1982-1997",
+                  wage_label,
+                  {0, NA},
+                  [&](std::ostream &log) {
+                    return to_distrs_series(panel, derived, "wage_cost", log);
+                  }});
+  jobs.push_back({"productivity_and_wage_cost_distrs_1982-1997",
+                  prod_wage_label,
+                  {0, NA},
+                  [&](std::ostream &log) {
+                    return to_productivity_and_wage_cost_series(panel, derived,
+                                                                log);
+                  }});
+
+  // Per Industry
+  for (int year_idx = 0; year_idx < years.size(); year_idx++) {
+    const int year = years[year_idx];
+    const std::string suffix = "_per_industry_" + std::to_string(year);
+
+    jobs.push_back({"labor_productivity_distrs" + suffix,
+                    prod_label,
+                    {0, NA},
+                    [&, year](std::ostream &log) {
+                      return to_distrs_series_per_industry(
+                          panel_divided, derived_divided, "productivity", year);
+                    }});
+    jobs.push_back({"wage_cost_distrs" + suffix,
+                    wage_label,
+                    {0, NA},
+                    [&, year](std::ostream &log) {
+                      return to_distrs_series_per_industry(
+                          panel_divided, derived_divided, "wage_cost", year);
+                    }});
+    jobs.push_back({"productivity_and_wage_cost_distrs" + suffix,
+                    prod_wage_label,
+                    {0, NA},
+                    [&, year_idx](std::ostream &log) {
+                      return to_productivity_and_wage_cost_series_per_industry(
+                          panel_divided, derived_divided, year_idx);
+                    }});
+  }
+  // END Per industry
+
+  jobs.push_back({"labor_productivity_distrs_no_selection_1982-1997",
+                  prod_label,
+                  {0, NA},
+                  [&](std::ostream &log) {
+                    return to_productivity_distrs_no_selection_series(db, log);
+                  }});
+  jobs.push_back(
+      {"labor_productivity_distrs_no_selection_interpolated_1982-1997",
+       prod_label,
+       {0, NA},
+       [&](std::ostream &log) {
+         return to_productivity_distrs_no_selection_series(
+             db_interpolated_no_selection, log);
+       }});
+
+  run_chart_jobs(jobs);
 
   return 0;
 }
@@ -1,6 +1,13 @@
 #include "../lib/db.h"
+#include "../lib/derived.h"
 #include "../lib/firm.h"
 #include "../lib/graph.h"
+#include "../lib/panel.h"
+#include "../lib/pool.h"
+#include "../lib/salter.h"
+#include "../lib/salter_stats.h"
+#include <functional>
+#include <sstream>
 
 #define LOW 1982
 #define HIGH 1997
@@ -9,26 +16,51 @@
 #define YEAR 1982
 #define CASE_ID 00000
 
+#define EXPORT_FORMAT Graph::PNG // Chart file format (PNG, SVG or PDF)
+#define N_THREADS 0 // Threads computing chart series (0: all hardware threads)
+
 const std::vector<int> years = {1982, 1990, 1997};
 const std::vector<int> years_fewer = {1982, 1997};
 
 namespace plan_database {
 
-void draw_one_firm_develops(Database db);
-void draw_productivity_distrs(Database db);
-void draw_productivity_distrs_per_industry(Database db, const int year);
-void draw_productivity_distrs_no_selection(Database db);
-void draw_productivity_distrs_no_selection_interpolated(Database db);
-void draw_wage_cost_distrs(Database db);
-void draw_wage_cost_distrs_per_industry(Database db, const int year);
-void draw_productivity_and_wage_cost_distrs(Database db);
-void draw_productivity_and_wage_cost_distrs_per_industry(Database db,
-                                                         const int year_idx);
+// One chart of the report. compute() builds the chart's series without Qt and
+// may run on any thread, writing its progress to the given stream. The chart
+// itself is created and exported on the main thread.
+struct ChartJob {
+  std::string path, y_label;
+  std::pair<double, double> y_range;
+  std::function<std::vector<Graph::Serie>(std::ostream &)> compute;
+  std::vector<Graph::Serie> series;
+  std::string log;
+};
+
+void run_chart_jobs(std::vector<ChartJob> &jobs);
+
+std::vector<Graph::Serie> to_one_firm_develops_series(Database db);
+std::vector<Graph::Serie> to_distrs_series(const FirmPanel &panel,
+                                           DerivedVariables &derived,
+                                           const std::string &variant,
+                                           std::ostream &log);
+std::vector<Graph::Serie>
+to_distrs_series_per_industry(const FirmPanel &panel, DerivedVariables &derived,
+                              const std::string &variant, const int year);
+std::vector<Graph::Serie>
+to_productivity_distrs_no_selection_series(const Database &db,
+                                           std::ostream &log);
+std::vector<Graph::Serie>
+to_productivity_and_wage_cost_series(const FirmPanel &panel,
+                                     DerivedVariables &derived,
+                                     std::ostream &log);
+std::vector<Graph::Serie> to_productivity_and_wage_cost_series_per_industry(
+    const FirmPanel &panel, DerivedVariables &derived, const int year_idx);
 
 std::pair<Graph::Serie, Graph::Serie>
-to_aligned_prod_wage_series(const std::vector<Firm> &firms, const int year_idx);
+to_aligned_prod_wage_series(const FirmPanel &panel, DerivedVariables &derived,
+                            const int year_idx);
 std::pair<Graph::Serie, Graph::Serie>
-to_aligned_prod_wage_series_per_industry(const std::vector<Firm> &firms,
+to_aligned_prod_wage_series_per_industry(const FirmPanel &panel,
+                                         DerivedVariables &derived,
                                          const int year_idx, const int mkt_id);
 
 } // namespace plan_database
@@ -0,0 +1,148 @@
+//
+//
+// NOTE:
+// Headless export of salter curves (no Qt). Every year MIN_YEAR-MAX_YEAR,
+// industry and variant is written to one long csv file, and their summary
+// statistics to another. Charts of chart_years are written as SVG/PDF.
+//
+//
+
+#include "export_salter.h"
+
+namespace plan_database {
+
+void export_salter_curves(const Database &db, const std::string &path) {
+  FirmPanel panel =
+      FirmPanel::from_cross_sections(db.plandata, db.macrodata, false);
+  FirmPanel panel_divided =
+      FirmPanel::from_cross_sections(db.plandata, db.macrodata, true);
+  DerivedVariables derived;
+
+  std::vector<std::string> header = {"variant", "industry", "year"};
+  header.insert(header.end(), SalterCurve::header.begin(),
+                SalterCurve::header.end());
+
+  std::vector<std::vector<std::string>> rows;
+  for (const std::string &variant : variants) {
+    for (int year = panel.year_low; year <= panel.year_high; year++) {
+      for (int mkt_id : {NO_MKT, RAW, IMED, DUR, NDUR}) {
+
+        // One residual firm for all markets, one per industry otherwise
+        const FirmPanel &p = mkt_id == NO_MKT ? panel : panel_divided;
+        SalterCurve curve = SalterCurve::from_panel(
+            p, derived.evaluate(p, "value_added"), derived.evaluate(p, variant),
+            year, mkt_id);
+        if (curve.size() == 0)
+          continue;
+
+        const std::string industry =
+            mkt_id == NO_MKT ? "ALL" : get_industry_code(mkt_id);
+        for (std::vector<std::string> &tokens : curve.tokenise()) {
+          tokens.insert(tokens.begin(),
+                        {variant, industry, std::to_string(year)});
+          rows.push_back(std::move(tokens));
+        }
+
+        if (BINARY)
+          curve.write_binary("salter_" + variant + "_" + industry + "_" +
+                             std::to_string(year) + ".bin");
+      }
+    }
+  }
+
+  csv::write(path, rows, ',', header);
+  std::cout << "Saved CSV: " << path << " (" << rows.size() << " steps)"
+            << std::endl;
+}
+
+void export_salter_summaries(const Database &db, const std::string &path) {
+  FirmPanel panel =
+      FirmPanel::from_cross_sections(db.plandata, db.macrodata, false);
+  FirmPanel panel_divided =
+      FirmPanel::from_cross_sections(db.plandata, db.macrodata, true);
+  DerivedVariables derived;
+
+  std::vector<int> all_years;
+  for (int year = panel.year_low; year <= panel.year_high; year++) {
+    all_years.push_back(year);
+  }
+
+  std::vector<SalterSummary> summaries;
+  for (const std::string &variant : variants) {
+    std::vector<SalterSummary> all = SalterSummary::summarise_all(
+        panel, derived, variant, all_years, {NO_MKT});
+    std::vector<SalterSummary> per_industry = SalterSummary::summarise_all(
+        panel_divided, derived, variant, all_years, {RAW, IMED, DUR, NDUR});
+
+    summaries.insert(summaries.end(), all.begin(), all.end());
+    summaries.insert(summaries.end(), per_industry.begin(),
+                     per_industry.end());
+  }
+
+  SalterSummary::write_csv(path, summaries);
+  std::cout << "Saved CSV: " << path << " (" << summaries.size()
+            << " curves)" << std::endl;
+}
+
+void export_salter_charts(const Database &db) {
+  FirmPanel panel =
+      FirmPanel::from_cross_sections(db.plandata, db.macrodata, false);
+  FirmPanel panel_divided =
+      FirmPanel::from_cross_sections(db.plandata, db.macrodata, true);
+  DerivedVariables derived;
+
+  const std::string years_str = std::to_string(chart_years.front()) + "-" +
+                                std::to_string(chart_years.back());
+
+  for (int i = 0; i < variants.size(); i++) {
+    const std::vector<double> &x = derived.evaluate(panel, "value_added");
+    const std::vector<double> &y = derived.evaluate(panel, variants[i]);
+
+    VectorChart chart("", "% of production", y_labels[i]);
+    chart.y_range = {0, NA};
+    for (int year : chart_years) {
+      chart.add_salter_curve(SalterCurve::from_panel(panel, x, y, year),
+                             std::to_string(year));
+    }
+    for (VectorChart::Format format : chart_formats) {
+      chart.write(variants[i] + "_distrs_" + years_str, 1000, 2000, format);
+    }
+
+    // Per industry
+    const std::vector<double> &x_divided =
+        derived.evaluate(panel_divided, "value_added");
+    const std::vector<double> &y_divided =
+        derived.evaluate(panel_divided, variants[i]);
+    for (int year : chart_years) {
+      VectorChart industry_chart("", "% of production", y_labels[i]);
+      industry_chart.y_range = {0, NA};
+      for (int mkt_id : {RAW, IMED, DUR, NDUR}) {
+        industry_chart.add_salter_curve(
+            SalterCurve::from_panel(panel_divided, x_divided, y_divided, year,
+                                    mkt_id),
+            get_industry_name(mkt_id));
+      }
+      for (VectorChart::Format format : chart_formats) {
+        industry_chart.write(variants[i] + "_distrs_per_industry_" +
+                                 std::to_string(year),
+                             1000, 2000, format);
+      }
+    }
+  }
+}
+
+} // namespace plan_database
+
+int main() {
+  plan_database::Database db;
+  db.plandata.parse_csv("../data/interpolated.csv", ',', true);
+  db.macrodata.parse_csv("../data/macrodatabase.csv");
+  db.plandata.filter_markets({DUR, NDUR, IMED, RAW});
+  db.macrodata.filter_markets({DUR, NDUR, IMED, RAW});
+
+  plan_database::export_salter_curves(db, "salter_curves.csv");
+  plan_database::export_salter_summaries(db, "salter_summaries.csv");
+  plan_database::export_salter_charts(db);
+
+  return 0;
+}
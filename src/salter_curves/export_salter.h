@@ -0,0 +1,29 @@
+#include "../lib/db.h"
+#include "../lib/derived.h"
+#include "../lib/firm.h"
+#include "../lib/panel.h"
+#include "../lib/salter.h"
+#include "../lib/salter_stats.h"
+#include "../lib/vector_chart.h"
+
+// Parameters
+#define BINARY false // Also write every curve as a binary file (salter_*.bin)
+const std::vector<std::string> variants = {
+    "productivity", // Value productivity per employee (MSEK)
+    "wage_cost",    // Wage cost per employee (MSEK)
+}; // Derived variables to draw salter curves of (weight: value added)
+const std::vector<std::string> y_labels = {
+    "Value productivity per employee (MSEK)",
+    "Wage cost per employee (MSEK)",
+}; // Chart y-axis label of each variant
+const std::vector<int> chart_years = {1982, 1990, 1997};
+const std::vector<plan_database::VectorChart::Format> chart_formats = {
+    plan_database::VectorChart::SVG, plan_database::VectorChart::PDF};
+
+namespace plan_database {
+
+void export_salter_curves(const Database &db, const std::string &path);
+void export_salter_summaries(const Database &db, const std::string &path);
+void export_salter_charts(const Database &db);
+
+} // namespace plan_database
@@ -1,7 +1,17 @@
 #!/bin/bash
 
+# Headless export of salter curve data (no Qt)
+g++ -O2 -std=c++17 -o export_salter export_salter.cpp ../lib/db.cpp ../lib/plandata.cpp ../lib/division.cpp ../lib/csv.cpp ../lib/macro.cpp ../lib/utility.cpp ../lib/firm.cpp ../lib/panel.cpp ../lib/derived.cpp ../lib/salter.cpp ../lib/salter_stats.cpp ../lib/vector_chart.cpp
+./export_salter
+rm export_salter
+
+# Headless year-by-year salter animation (no Qt)
+g++ -O2 -std=c++17 -pthread -o animate_salter animate_salter.cpp ../lib/db.cpp ../lib/plandata.cpp ../lib/division.cpp ../lib/csv.cpp ../lib/macro.cpp ../lib/utility.cpp ../lib/firm.cpp ../lib/panel.cpp ../lib/derived.cpp ../lib/salter.cpp ../lib/vector_chart.cpp ../lib/pool.cpp
+./animate_salter
+rm animate_salter
+
 # macOS Qt6 framework build script
-QT_PATH="/opt/homebrew/opt/qt6"
+QT_PATH="${QT_PATH:-/opt/homebrew/opt/qt6}" # Override with QT_PATH=<path> ./run.sh
 
 # Check if Qt6 exists
 if [ ! -d "$QT_PATH" ]; then
@@ -13,20 +23,22 @@ fi
 echo "Building with Qt frameworks at: $QT_PATH"
 
 # Compile using frameworks (macOS approach)
-g++ -std=c++17 -O2 \
+g++ -std=c++17 -O2 -pthread \
   -I$QT_PATH/include \
   -I$QT_PATH/include/QtCore \
   -I$QT_PATH/include/QtWidgets \
   -I$QT_PATH/include/QtCharts \
   -I$QT_PATH/include/QtGui \
   -I$QT_PATH/include/QtPrintSupport \
-  draw_salter.cpp ../lib/db.cpp ../lib/plandata.cpp ../lib/macro.cpp ../lib/division.cpp ../lib/csv.cpp ../lib/firm.cpp ../lib/graph.cpp ../lib/utility.cpp \
+  -I$QT_PATH/include/QtSvg \
+  draw_salter.cpp ../lib/db.cpp ../lib/plandata.cpp ../lib/macro.cpp ../lib/division.cpp ../lib/csv.cpp ../lib/firm.cpp ../lib/panel.cpp ../lib/derived.cpp ../lib/salter.cpp ../lib/salter_stats.cpp ../lib/pool.cpp ../lib/graph.cpp ../lib/utility.cpp \
   -F$QT_PATH/lib \
   -framework QtCore \
   -framework QtWidgets \
   -framework QtCharts \
   -framework QtGui \
   -framework QtPrintSupport \
+  -framework QtSvg \
   -rpath $QT_PATH/lib \
   -o salter_curve
 
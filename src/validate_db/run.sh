@@ -0,0 +1,4 @@
+#!/bin/bash
+g++ -O2 -std=c++17 -o run validate_db.cpp ../lib/db.cpp ../lib/plandata.cpp ../lib/division.cpp ../lib/csv.cpp ../lib/macro.cpp ../lib/utility.cpp ../lib/plan_columns.cpp ../lib/validation.cpp
+./run
+rm run
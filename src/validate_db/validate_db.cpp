@@ -0,0 +1,52 @@
+//
+//
+// NOTE:
+// Validates a delivery of the planning survey in one pass over its columns:
+// the accounting identities and last year / this year rules of
+// validation::survey_rules() (within ABS_TOLERANCE or REL_TOLERANCE), and
+// robust outliers of outlier_vars per year. Every violation and outlier is
+// written to REPORT_PATH, counts are printed per rule.
+//
+//
+
+#include "validate_db.h"
+
+namespace plan_database {
+
+void validate_db(const PlanData &plandata) {
+  using namespace validation;
+
+  const PlanColumns columns(plandata);
+  const std::vector<Rule> rules = survey_rules();
+
+  const std::vector<Violation> violations =
+      check_rules(columns, rules, ABS_TOLERANCE, REL_TOLERANCE);
+  const std::vector<Outlier> outliers =
+      find_outliers(columns, outlier_vars, Z_THRESHOLD);
+  write_report(REPORT_PATH, columns, rules, violations, outliers);
+
+  std::vector<int> n_violations(rules.size(), 0);
+  for (const Violation &v : violations) {
+    n_violations[v.rule_idx]++;
+  }
+
+  std::cout << columns.size() << " observations, " << violations.size()
+            << " violations, " << outliers.size() << " outliers" << std::endl;
+  for (int r = 0; r < rules.size(); r++) {
+    if (n_violations[r])
+      std::cout << "  " << rules[r].name << ": " << n_violations[r]
+                << std::endl;
+  }
+  std::cout << "Report written to " << REPORT_PATH << std::endl;
+}
+
+} // namespace plan_database
+
+int main() {
+  plan_database::Database db;
+  db.plandata.parse_csv(DATA_PATH, ',', true);
+
+  plan_database::validate_db(db.plandata);
+
+  return 0;
+}
@@ -0,0 +1,22 @@
+#include "../lib/db.h"
+#include "../lib/plan_columns.h"
+#include "../lib/validation.h"
+
+// Parameters
+#define DATA_PATH "../data/plan1975-2000-full.csv" // Delivery to validate
+#define ABS_TOLERANCE                                                          \
+  1 // Absolute difference allowed in identities (rounding of the answers)
+#define REL_TOLERANCE 0.01 // Relative difference allowed in identities
+#define Z_THRESHOLD                                                            \
+  5 // Robust z-score (of logs, per year) beyond which a value is an outlier
+#define REPORT_PATH "validation_report.csv"
+const std::vector<int> outlier_vars = {
+    1,  4,  7,  10, 13, // anställda, timmar, fakturering (utland, hemma, total)
+    16, 25, 36,         // inköp, lönekostnader, investeringar
+}; // Variables (0-indexed) to check for outliers
+
+namespace plan_database {
+
+void validate_db(const PlanData &plandata);
+
+} // namespace plan_database